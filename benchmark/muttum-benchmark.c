@@ -0,0 +1,704 @@
+/* muttum-benchmark.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <glib/gstdio.h>
+
+#include "muttum.h"
+#include "muttum-dictionary.h"
+#include "muttum-fold.h"
+
+/*
+ * Benchmarks of the engine hot paths against the word list given by the
+ * MUTTUM_DICTIONARY_URI and MUTTUM_DICTIONARY_INDEX environment variables.
+ *
+ * Usage: muttum-benchmark dictionary-load|dictionary-lookup|dictionary-memory|dictionary-backends|word-init|validate|snapshot|score
+ *
+ * Each measure is printed as one JSON object by line. dictionary-memory
+ * fails when the index of a generated word list goes over its memory
+ * budget, the index is compiled by the muttum-dictionary-compile given by
+ * MUTTUM_DICTIONARY_COMPILE. dictionary-backends fails when the index
+ * and automaton backends don't play the same words.
+ * */
+
+#define BENCHMARK_SEED 42
+#define BENCHMARK_LOAD_ITERATIONS 50
+#define BENCHMARK_LOOKUP_ITERATIONS 2000
+#define BENCHMARK_LOOKUP_BATCH 1000
+#define BENCHMARK_WORD_INIT_ITERATIONS 20000
+#define BENCHMARK_VALIDATE_ITERATIONS 100000
+#define BENCHMARK_SNAPSHOT_ITERATIONS 100000
+#define BENCHMARK_SCORE_ITERATIONS 2000
+#define BENCHMARK_MEMORY_WORDS 100000
+// Memory allowed for the index of 100k words: entries, buckets, keys and
+// spellings take about 40 bytes by word
+#define BENCHMARK_MEMORY_BUDGET (8 * 1024 * 1024)
+
+static gint64 benchmark_now (void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (gint64) now.tv_sec * G_GINT64_CONSTANT(1000000000) + now.tv_nsec;
+}
+
+static gint benchmark_compare_samples (gconstpointer a, gconstpointer b)
+{
+  gint64 first = *(const gint64 *) a;
+  gint64 second = *(const gint64 *) b;
+  return (first > second) - (first < second);
+}
+
+/*
+ * Prints latency statistics of @samples (nanoseconds) and the throughput
+ * as @units_per_sample units by sample.
+ */
+static void benchmark_report (
+    const gchar *name,
+    GArray *samples,
+    gdouble units_per_sample,
+    const gchar *unit)
+{
+  gint64 total = 0;
+  for (guint i = 0; i < samples->len; i += 1) {
+    total += g_array_index(samples, gint64, i);
+  }
+
+  g_array_sort(samples, benchmark_compare_samples);
+
+  gdouble mean = samples->len > 0 ? (gdouble) total / samples->len : 0;
+  gint64 p50 = samples->len > 0 ? g_array_index(samples, gint64, samples->len / 2) : 0;
+  gint64 p99 = samples->len > 0 ? g_array_index(samples, gint64, samples->len * 99 / 100) : 0;
+  gint64 max = samples->len > 0 ? g_array_index(samples, gint64, samples->len - 1) : 0;
+  gdouble throughput = total > 0 ? units_per_sample * samples->len * 1e9 / total : 0;
+
+  g_print("{\"benchmark\": \"%s\", \"iterations\": %u, \"total_ns\": %" G_GINT64_FORMAT
+      ", \"mean_ns\": %.1f, \"p50_ns\": %" G_GINT64_FORMAT ", \"p99_ns\": %" G_GINT64_FORMAT
+      ", \"max_ns\": %" G_GINT64_FORMAT ", \"throughput\": %.1f, \"unit\": \"%s\"}\n",
+      name, samples->len, total, mean, p50, p99, max, throughput, unit);
+}
+
+static GFile *benchmark_get_dictionary_file (void)
+{
+  const gchar *uri = g_getenv("MUTTUM_DICTIONARY_URI");
+  if (!uri) {
+    g_error("MUTTUM_DICTIONARY_URI must be set");
+  }
+  return g_file_new_for_uri(uri);
+}
+
+/*
+ * Returns: (transfer full): folded words of the word list, as typed by players
+ */
+static GPtrArray *benchmark_load_folded_words (void)
+{
+  g_autoptr(GFile) file = benchmark_get_dictionary_file();
+  g_autoptr(GError) error = NULL;
+  g_autofree gchar *contents = NULL;
+
+  if (!g_file_load_contents(file, NULL, &contents, NULL, NULL, &error)) {
+    g_error("Unable to read word list: %s", error->message);
+  }
+
+  GPtrArray *words = g_ptr_array_new_with_free_func(g_free);
+  g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+  for (guint i = 0; lines[i]; i += 1) {
+    g_autofree gchar *ascii = g_str_to_ascii(lines[i], "C");
+    gchar *word = g_ascii_strdown(ascii, -1);
+    gsize length = strlen(word);
+    gboolean is_playable = length >= 5 && length <= 8 && word[1] != word[0];
+
+    for (gsize j = 0; j < length && is_playable; j += 1) {
+      is_playable = word[j] >= 'a' && word[j] <= 'z';
+    }
+
+    if (is_playable) {
+      g_ptr_array_add(words, word);
+    } else {
+      g_free(word);
+    }
+  }
+
+  return words;
+}
+
+/*
+ * Returns: (transfer full): an engine with the default properties, the
+ * first one loads the word list
+ */
+static MuttumEngine *benchmark_engine_new (void)
+{
+  g_autoptr(GError) error = NULL;
+  MuttumEngine *engine = g_initable_new(MUTTUM_TYPE_ENGINE, NULL, &error, NULL);
+
+  if (!engine) {
+    g_error("Unable to load word list: %s", error->message);
+  }
+
+  return engine;
+}
+
+static void benchmark_dictionary_load (void)
+{
+  g_autoptr(GFile) file = benchmark_get_dictionary_file();
+  const gchar *index_path = g_getenv("MUTTUM_DICTIONARY_INDEX");
+  g_autoptr(GError) error = NULL;
+  UCollator *collator = muttum_dictionary_open_collator("fr_FR");
+  g_autoptr(GArray) text_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  g_autoptr(GArray) index_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  g_autoptr(GArray) automaton_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  guint n_words = 0;
+
+  for (guint i = 0; i < BENCHMARK_LOAD_ITERATIONS; i += 1) {
+    // Word list parsing and collation
+    gint64 start = benchmark_now();
+    MuttumDictionaryIndex *index = muttum_dictionary_index_new(file, "fr_FR", 5, 8, &error);
+    gint64 duration = benchmark_now() - start;
+    if (!index) {
+      g_error("Unable to load word list: %s", error->message);
+    }
+    g_array_append_val(text_samples, duration);
+    n_words = muttum_dictionary_index_get_n_words(index);
+
+    // Automaton built from the index
+    start = benchmark_now();
+    MuttumDictionary *dictionary = muttum_dictionary_new(index, MUTTUM_DICTIONARY_BACKEND_AUTOMATON);
+    duration = benchmark_now() - start;
+    g_array_append_val(automaton_samples, duration);
+    muttum_dictionary_free(dictionary);
+
+    // Precompiled index mapping
+    if (index_path) {
+      start = benchmark_now();
+      index = muttum_dictionary_index_open(index_path, file, collator, "fr_FR", 5, 8, &error);
+      duration = benchmark_now() - start;
+      if (!index) {
+        g_error("Unable to open index: %s", error->message);
+      }
+      g_array_append_val(index_samples, duration);
+      muttum_dictionary_index_free(index);
+    }
+  }
+
+  benchmark_report("dictionary-load-text", text_samples, n_words, "words/s");
+  benchmark_report("dictionary-load-automaton", automaton_samples, n_words, "words/s");
+  if (index_path) {
+    benchmark_report("dictionary-load-index", index_samples, n_words, "words/s");
+  }
+
+  ucol_close(collator);
+}
+
+/*
+ * Looks up words of the word list and as many unknown words in the
+ * dictionary selected by MUTTUM_DICTIONARY_BACKEND, by collation key and by
+ * fold key, without the key computations. The automaton backend is only
+ * looked up by fold key.
+ */
+static void benchmark_dictionary_lookup (void)
+{
+  g_autoptr(GFile) file = benchmark_get_dictionary_file();
+  const gchar *index_path = g_getenv("MUTTUM_DICTIONARY_INDEX");
+  g_autoptr(GError) error = NULL;
+  UCollator *collator = muttum_dictionary_open_collator("fr_FR");
+  g_autoptr(GPtrArray) words = benchmark_load_folded_words();
+  g_autoptr(GArray) key_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  g_autoptr(GArray) folded_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+
+  MuttumDictionaryIndex *index = index_path
+    ? muttum_dictionary_index_open(index_path, file, collator, "fr_FR", 5, 8, &error)
+    : muttum_dictionary_index_new(file, "fr_FR", 5, 8, &error);
+  if (!index) {
+    g_error("Unable to load word list: %s", error->message);
+  }
+  MuttumDictionaryBackend backend = muttum_dictionary_backend_from_string(g_getenv("MUTTUM_DICTIONARY_BACKEND"));
+  g_autoptr(MuttumDictionary) dictionary = muttum_dictionary_new(index, backend);
+
+  // Every other query ends with a letter no French word ends with
+  g_autoptr(GPtrArray) keys = g_ptr_array_new_with_free_func(g_free);
+  g_autoptr(GArray) lengths = g_array_new(FALSE, FALSE, sizeof(guint));
+  g_autoptr(GArray) fold_keys = g_array_new(FALSE, FALSE, sizeof(guint64));
+  for (guint i = 0; i < BENCHMARK_LOOKUP_BATCH; i += 1) {
+    g_autofree gchar *word = g_strdup(g_ptr_array_index(words, g_random_int_range(0, words->len)));
+    guint length = strlen(word);
+    gsize key_size = 0;
+
+    if (i % 2 == 1) {
+      word[length - 1] = 'q';
+    }
+
+    g_ptr_array_add(keys, muttum_dictionary_compute_key(collator, word, NULL, 0, &key_size));
+    g_array_append_val(lengths, length);
+    guint64 fold_key = muttum_fold_pack(word, length);
+    g_array_append_val(fold_keys, fold_key);
+  }
+
+  guint n_found = 0;
+  for (guint i = 0; i < BENCHMARK_LOOKUP_ITERATIONS; i += 1) {
+    gint64 start = 0;
+    gint64 duration = 0;
+
+    if (backend == MUTTUM_DICTIONARY_BACKEND_INDEX) {
+      start = benchmark_now();
+      for (guint j = 0; j < BENCHMARK_LOOKUP_BATCH; j += 1) {
+        n_found += muttum_dictionary_contains(dictionary, g_ptr_array_index(keys, j),
+            g_array_index(lengths, guint, j));
+      }
+      duration = benchmark_now() - start;
+      g_array_append_val(key_samples, duration);
+    }
+
+    start = benchmark_now();
+    for (guint j = 0; j < BENCHMARK_LOOKUP_BATCH; j += 1) {
+      n_found += muttum_dictionary_contains_folded(dictionary, g_array_index(fold_keys, guint64, j));
+    }
+    duration = benchmark_now() - start;
+    g_array_append_val(folded_samples, duration);
+  }
+  g_assert(n_found > 0);
+
+  if (backend == MUTTUM_DICTIONARY_BACKEND_INDEX) {
+    benchmark_report("dictionary-lookup-key", key_samples, BENCHMARK_LOOKUP_BATCH, "lookups/s");
+  }
+  benchmark_report("dictionary-lookup-folded", folded_samples, BENCHMARK_LOOKUP_BATCH, "lookups/s");
+
+  ucol_close(collator);
+}
+
+/*
+ * Returns: resident memory of the process in bytes, 0 if unknown
+ */
+static gsize benchmark_get_resident_size (void)
+{
+  g_autofree gchar *statm = NULL;
+  gsize resident_pages = 0;
+
+  if (!g_file_get_contents("/proc/self/statm", &statm, NULL, NULL)
+      || sscanf(statm, "%*s %zu", &resident_pages) != 1) {
+    return 0;
+  }
+
+  return resident_pages * sysconf(_SC_PAGESIZE);
+}
+
+/*
+ * Writes @n_words distinct words of 5 to 8 letters, some of them accented,
+ * in a temporary word list.
+ *
+ * Returns: (transfer full): the word list
+ */
+static GFile *benchmark_generate_word_list (guint n_words)
+{
+  g_autoptr(GError) error = NULL;
+  g_autofree gchar *path = NULL;
+  gint fd = g_file_open_tmp("muttum-benchmark-XXXXXX.txt", &path, &error);
+  if (fd < 0) {
+    g_error("Unable to create word list: %s", error->message);
+  }
+  close(fd);
+
+  g_autoptr(GString) contents = g_string_new(NULL);
+  for (guint i = 0; i < n_words; i += 1) {
+    guint length = 5 + i % 4;
+    guint value = i;
+
+    for (guint j = 0; j < length; j += 1) {
+      gchar letter = 'a' + value % 26;
+      value /= 26;
+      if (letter == 'e' && j % 2 == 1) {
+        g_string_append(contents, "é");
+      } else {
+        g_string_append_c(contents, letter);
+      }
+    }
+    g_string_append_c(contents, '\n');
+  }
+
+  if (!g_file_set_contents(path, contents->str, contents->len, &error)) {
+    g_error("Unable to write word list: %s", error->message);
+  }
+
+  return g_file_new_for_path(path);
+}
+
+/*
+ * Compiles @file to an index with @compile, in its own process so the build
+ * transients don't count in the memory of this one.
+ *
+ * Returns: (transfer full): path of the index
+ */
+static gchar *benchmark_compile_index (const gchar *compile, GFile *file)
+{
+  g_autoptr(GError) error = NULL;
+  gchar *index_path = NULL;
+  gint fd = g_file_open_tmp("muttum-benchmark-XXXXXX.muttumdict", &index_path, &error);
+  if (fd < 0) {
+    g_error("Unable to create index: %s", error->message);
+  }
+  close(fd);
+
+  g_autofree gchar *path = g_file_get_path(file);
+  const gchar *argv[] = { compile, "fr_FR", "5", "8", path, index_path, NULL };
+  g_autoptr(GSubprocess) process = g_subprocess_newv(argv, G_SUBPROCESS_FLAGS_NONE, &error);
+  if (!process || !g_subprocess_wait_check(process, NULL, &error)) {
+    g_error("Unable to compile index: %s", error->message);
+  }
+
+  return index_path;
+}
+
+static gboolean benchmark_dictionary_memory (void)
+{
+  const gchar *compile = g_getenv("MUTTUM_DICTIONARY_COMPILE");
+  if (!compile) {
+    g_error("MUTTUM_DICTIONARY_COMPILE must be set");
+  }
+
+  g_autoptr(GFile) file = benchmark_generate_word_list(BENCHMARK_MEMORY_WORDS);
+  g_autofree gchar *path = g_file_get_path(file);
+  g_autofree gchar *index_path = benchmark_compile_index(compile, file);
+  g_autoptr(GError) error = NULL;
+
+  // Collation data is loaded by the collator, it's shared by every
+  // dictionary and not counted
+  UCollator *collator = muttum_dictionary_open_collator("fr_FR");
+
+  gsize before = benchmark_get_resident_size();
+  MuttumDictionaryIndex *index = muttum_dictionary_index_open(index_path, file, collator, "fr_FR", 5, 8, &error);
+  if (!index) {
+    g_error("Unable to open index: %s", error->message);
+  }
+  guint n_words = muttum_dictionary_index_get_n_words(index);
+  MuttumDictionary *dictionary = muttum_dictionary_new(index, MUTTUM_DICTIONARY_BACKEND_INDEX);
+  gsize after = benchmark_get_resident_size();
+
+  gsize size = muttum_dictionary_get_size(dictionary);
+  gsize resident_size = after > before ? after - before : 0;
+  gdouble by_100k_words = n_words > 0 ? resident_size * 100000.0 / n_words : 0;
+  gdouble size_by_100k_words = n_words > 0 ? size * 100000.0 / n_words : 0;
+
+  g_print("{\"benchmark\": \"dictionary-memory\", \"words\": %u, \"dictionary_bytes\": %" G_GSIZE_FORMAT
+      ", \"resident_bytes\": %" G_GSIZE_FORMAT ", \"resident_bytes_by_100k_words\": %.0f, \"budget\": %d}\n",
+      n_words, size, resident_size, by_100k_words, BENCHMARK_MEMORY_BUDGET);
+
+  muttum_dictionary_free(dictionary);
+  ucol_close(collator);
+  g_unlink(index_path);
+  g_unlink(path);
+
+  // The size is checked even where the resident memory is unknown
+  if (size_by_100k_words > BENCHMARK_MEMORY_BUDGET) {
+    g_printerr("Dictionary takes %.0f bytes by 100k words, over its budget of %d bytes\n",
+        size_by_100k_words, BENCHMARK_MEMORY_BUDGET);
+    return FALSE;
+  }
+
+  if (before == 0) {
+    g_printerr("Resident memory is unknown on this system, only the dictionary size is checked\n");
+    return TRUE;
+  }
+
+  if (by_100k_words > BENCHMARK_MEMORY_BUDGET) {
+    g_printerr("Dictionary uses %.0f resident bytes by 100k words, over its budget of %d bytes\n",
+        by_100k_words, BENCHMARK_MEMORY_BUDGET);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/*
+ * Words the board can't show as their a-z letters, appended to the word
+ * list so both backends have to leave them out.
+ */
+static const gchar *benchmark_unplayable_words[] = {
+  "sœurs", "cœurs", "vœux", "œuvrer", "nœuds", "ex-aequo", "aujourd'hui",
+};
+
+/*
+ * Checks both dictionary backends play the same words, at the same
+ * positions since saved games keep the position of their word.
+ */
+static gboolean benchmark_dictionary_backends (void)
+{
+  g_autoptr(GFile) source = benchmark_get_dictionary_file();
+  g_autoptr(GError) error = NULL;
+  g_autofree gchar *contents = NULL;
+  gsize size = 0;
+
+  if (!g_file_load_contents(source, NULL, &contents, &size, NULL, &error)) {
+    g_error("Unable to read word list: %s", error->message);
+  }
+
+  g_autofree gchar *path = NULL;
+  gint fd = g_file_open_tmp("muttum-benchmark-XXXXXX.txt", &path, &error);
+  if (fd < 0) {
+    g_error("Unable to create word list: %s", error->message);
+  }
+  close(fd);
+
+  g_autoptr(GString) words = g_string_new_len(contents, size);
+  for (guint i = 0; i < G_N_ELEMENTS(benchmark_unplayable_words); i += 1) {
+    g_string_append_printf(words, "\n%s\n", benchmark_unplayable_words[i]);
+  }
+  if (!g_file_set_contents(path, words->str, words->len, &error)) {
+    g_error("Unable to write word list: %s", error->message);
+  }
+
+  g_autoptr(GFile) file = g_file_new_for_path(path);
+  MuttumDictionaryIndex *index = muttum_dictionary_index_new(file, "fr_FR", 5, 8, &error);
+  if (!index) {
+    g_error("Unable to build index: %s", error->message);
+  }
+  MuttumDictionaryIndex *automaton_index = muttum_dictionary_index_new(file, "fr_FR", 5, 8, &error);
+  if (!automaton_index) {
+    g_error("Unable to build index: %s", error->message);
+  }
+  g_unlink(path);
+
+  g_autoptr(MuttumDictionary) dictionary = muttum_dictionary_new(index, MUTTUM_DICTIONARY_BACKEND_INDEX);
+  g_autoptr(MuttumDictionary) automaton = muttum_dictionary_new(automaton_index, MUTTUM_DICTIONARY_BACKEND_AUTOMATON);
+  guint n_playable = 0;
+  guint n_mismatches = 0;
+
+  for (guint length = 5; length <= 8; length += 1) {
+    guint n_words = muttum_dictionary_get_n_playable(dictionary, length);
+    if (n_words != muttum_dictionary_get_n_playable(automaton, length)) {
+      g_printerr("%u words of %u letters with the index backend, %u with the automaton backend\n",
+          n_words, length, muttum_dictionary_get_n_playable(automaton, length));
+      return FALSE;
+    }
+
+    for (guint position = 0; position < n_words; position += 1) {
+      gchar buffer[MUTTUM_DICTIONARY_FOLDED_SIZE];
+      gchar automaton_buffer[MUTTUM_DICTIONARY_FOLDED_SIZE];
+      const gchar *word = muttum_dictionary_get_playable(dictionary, length, position, buffer);
+      const gchar *automaton_word = muttum_dictionary_get_playable(automaton, length, position, automaton_buffer);
+
+      if (strcmp(word, automaton_word) != 0) {
+        if (n_mismatches < 10) {
+          g_printerr("Word %u of %u letters is %s with the index backend, %s with the automaton backend\n",
+              position, length, word, automaton_word);
+        }
+        n_mismatches += 1;
+      }
+    }
+    n_playable += n_words;
+  }
+
+  g_print("{\"benchmark\": \"dictionary-backends\", \"playable\": %u, \"mismatches\": %u}\n",
+      n_playable, n_mismatches);
+
+  return n_mismatches == 0;
+}
+
+static void benchmark_word_init (void)
+{
+  g_autoptr(GArray) samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  g_autoptr(GArray) reset_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+
+  // First engine loads the dictionary and keeps it loaded between games
+  g_autoptr(MuttumEngine) keeper = benchmark_engine_new();
+
+  for (guint i = 0; i < BENCHMARK_WORD_INIT_ITERATIONS; i += 1) {
+    gint64 start = benchmark_now();
+    MuttumEngine *engine = benchmark_engine_new();
+    gint64 duration = benchmark_now() - start;
+    g_array_append_val(samples, duration);
+    g_object_unref(engine);
+  }
+
+  // Same new games, reusing the game state of one engine
+  for (guint i = 0; i < BENCHMARK_WORD_INIT_ITERATIONS; i += 1) {
+    gint64 start = benchmark_now();
+    muttum_engine_reset(keeper);
+    gint64 duration = benchmark_now() - start;
+    g_array_append_val(reset_samples, duration);
+  }
+
+  benchmark_report("word-init", samples, 1, "games/s");
+  benchmark_report("word-init-reset", reset_samples, 1, "games/s");
+}
+
+static void benchmark_validate (void)
+{
+  g_autoptr(GPtrArray) words = benchmark_load_folded_words();
+  g_autoptr(GPtrArray) candidates = g_ptr_array_new();
+  g_autoptr(GArray) samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+
+  g_autoptr(MuttumEngine) engine = benchmark_engine_new();
+
+  while (samples->len < BENCHMARK_VALIDATE_ITERATIONS) {
+    muttum_engine_reset(engine);
+    guint length = 0;
+    gchar first_letter = muttum_engine_peek_board(engine, NULL, &length)[0].letter;
+
+    // Guesses are words of the word list the player may type
+    g_ptr_array_set_size(candidates, 0);
+    for (guint i = 0; i < words->len; i += 1) {
+      const gchar *word = g_ptr_array_index(words, i);
+      if (word[0] == first_letter && strlen(word) == length) {
+        g_ptr_array_add(candidates, (gpointer) word);
+      }
+    }
+
+    while (candidates->len > 0
+        && muttum_engine_get_game_state(engine) == MUTTUM_ENGINE_STATE_CONTINUE
+        && samples->len < BENCHMARK_VALIDATE_ITERATIONS) {
+      const gchar *guess = g_ptr_array_index(candidates, g_random_int_range(0, candidates->len));
+      g_autoptr(GError) error = NULL;
+
+      for (gsize i = 1; i < length; i += 1) {
+        muttum_engine_add_letter(engine, guess[i]);
+      }
+
+      gint64 start = benchmark_now();
+      muttum_engine_validate(engine, &error);
+      gint64 duration = benchmark_now() - start;
+      g_array_append_val(samples, duration);
+
+      if (error) {
+        for (gsize i = 1; i < length; i += 1) {
+          muttum_engine_remove_letter(engine);
+        }
+      }
+    }
+  }
+
+  benchmark_report("validate", samples, 1, "guesses/s");
+}
+
+static void benchmark_snapshot (void)
+{
+  g_autoptr(GArray) board_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  g_autoptr(GArray) view_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  g_autoptr(GArray) alphabet_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  g_autoptr(MuttumEngine) engine = benchmark_engine_new();
+
+  for (guint i = 0; i < BENCHMARK_SNAPSHOT_ITERATIONS; i += 1) {
+    gint64 start = benchmark_now();
+    GPtrArray *board = muttum_engine_get_board_state(engine);
+    g_ptr_array_unref(board);
+    gint64 duration = benchmark_now() - start;
+    g_array_append_val(board_samples, duration);
+
+    // Reads every letter, as a frame of the window does
+    guint n_rows = 0;
+    guint length = 0;
+    guint n_well_placed = 0;
+    start = benchmark_now();
+    const MuttumLetter *view = muttum_engine_peek_board(engine, &n_rows, &length);
+    for (guint letter = 0; letter < n_rows * length; letter += 1) {
+      n_well_placed += view[letter].state == MUTTUM_LETTER_WELL_PLACED;
+    }
+    duration = benchmark_now() - start;
+    g_array_append_val(view_samples, duration);
+    g_assert(n_well_placed == 0);
+
+    start = benchmark_now();
+    GPtrArray *alphabet = muttum_engine_get_alphabet_state(engine);
+    g_ptr_array_unref(alphabet);
+    duration = benchmark_now() - start;
+    g_array_append_val(alphabet_samples, duration);
+  }
+
+  benchmark_report("board-state", board_samples, 1, "snapshots/s");
+  benchmark_report("board-view", view_samples, 1, "snapshots/s");
+  benchmark_report("alphabet-state", alphabet_samples, 1, "snapshots/s");
+}
+
+static void benchmark_score (void)
+{
+  g_autoptr(GPtrArray) words = benchmark_load_folded_words();
+  g_autoptr(GArray) samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  const guint length = 8;
+  g_autoptr(GArray) targets = g_array_new(FALSE, FALSE, sizeof(guint64));
+
+  for (guint i = 0; i < words->len; i += 1) {
+    const gchar *word = g_ptr_array_index(words, i);
+    if (strlen(word) == length) {
+      guint64 packed = muttum_score_pack_word(word, length);
+      g_array_append_val(targets, packed);
+    }
+  }
+
+  if (targets->len == 0) {
+    g_error("No word of %u letters in the word list", length);
+  }
+
+  // Repeat the targets so a batch is as large as a length bucket
+  while (targets->len < 4096) {
+    g_array_append_vals(targets, targets->data, MIN(targets->len, 4096 - targets->len));
+  }
+
+  g_autofree guint16 *patterns = g_new(guint16, targets->len);
+  for (guint i = 0; i < BENCHMARK_SCORE_ITERATIONS; i += 1) {
+    guint64 guess = g_array_index(targets, guint64, g_random_int_range(0, targets->len));
+
+    gint64 start = benchmark_now();
+    muttum_score_batch(guess, (const guint64 *) targets->data, targets->len, length, patterns);
+    gint64 duration = benchmark_now() - start;
+    g_array_append_val(samples, duration);
+  }
+
+  g_autofree gchar *name = g_strdup_printf("score-%s", muttum_score_get_kernel_name());
+  benchmark_report(name, samples, targets->len, "patterns/s");
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  if (argc != 2) {
+    g_printerr("Usage: %s dictionary-load|dictionary-lookup|dictionary-memory|dictionary-backends|word-init|validate|snapshot|score\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  g_random_set_seed(BENCHMARK_SEED);
+
+  if (g_strcmp0(argv[1], "dictionary-load") == 0) {
+    benchmark_dictionary_load();
+  } else if (g_strcmp0(argv[1], "dictionary-lookup") == 0) {
+    benchmark_dictionary_lookup();
+  } else if (g_strcmp0(argv[1], "dictionary-memory") == 0) {
+    if (!benchmark_dictionary_memory()) {
+      return EXIT_FAILURE;
+    }
+  } else if (g_strcmp0(argv[1], "dictionary-backends") == 0) {
+    if (!benchmark_dictionary_backends()) {
+      return EXIT_FAILURE;
+    }
+  } else if (g_strcmp0(argv[1], "word-init") == 0) {
+    benchmark_word_init();
+  } else if (g_strcmp0(argv[1], "validate") == 0) {
+    benchmark_validate();
+  } else if (g_strcmp0(argv[1], "snapshot") == 0) {
+    benchmark_snapshot();
+  } else if (g_strcmp0(argv[1], "score") == 0) {
+    benchmark_score();
+  } else {
+    g_printerr("Unknown benchmark: %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,404 @@
+/* muttum-server-load.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+
+/*
+ * Load generator of muttum-server. It starts the server on a temporary
+ * socket, then clients play games concurrently with random guesses of the
+ * word list given by the MUTTUM_DICTIONARY_URI environment variable.
+ *
+ * Usage: muttum-server-load [--clients N] [--sessions N] [--games N] SERVER
+ *
+ * The sessions throughput and the guess latency, as seen by the clients,
+ * are printed as one JSON object by line like muttum-benchmark.
+ * */
+
+#define LOAD_SEED 42
+// A session is abandoned after this number of rejected guesses in a row
+#define LOAD_REJECTED_MAX 16
+
+typedef struct {
+  // Words by length and first letter, see load_words_get_bucket()
+  GPtrArray *buckets[9][26];
+} LoadWords;
+
+typedef struct {
+  guint id;
+  guint length;
+  gchar first_letter;
+  guint n_rejected;
+} LoadSession;
+
+typedef struct {
+  const gchar *socket_path;
+  LoadWords *words;
+  guint n_sessions;
+  guint n_games;
+  GRand *rand;
+
+  // Results
+  GArray *guess_samples;
+  guint n_played;
+  guint n_abandoned;
+} LoadClient;
+
+static gint64 load_now (void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (gint64) now.tv_sec * G_GINT64_CONSTANT(1000000000) + now.tv_nsec;
+}
+
+static gint load_compare_samples (gconstpointer a, gconstpointer b)
+{
+  gint64 first = *(const gint64 *) a;
+  gint64 second = *(const gint64 *) b;
+  return (first > second) - (first < second);
+}
+
+/*
+ * Same output as benchmark_report() of muttum-benchmark.
+ */
+static void load_report (
+    const gchar *name,
+    GArray *samples,
+    gint64 total,
+    gdouble units,
+    const gchar *unit)
+{
+  g_array_sort(samples, load_compare_samples);
+
+  gdouble mean = samples->len > 0 ? (gdouble) total / samples->len : 0;
+  gint64 p50 = samples->len > 0 ? g_array_index(samples, gint64, samples->len / 2) : 0;
+  gint64 p99 = samples->len > 0 ? g_array_index(samples, gint64, samples->len * 99 / 100) : 0;
+  gint64 max = samples->len > 0 ? g_array_index(samples, gint64, samples->len - 1) : 0;
+  gdouble throughput = total > 0 ? units * 1e9 / total : 0;
+
+  g_print("{\"benchmark\": \"%s\", \"iterations\": %u, \"total_ns\": %" G_GINT64_FORMAT
+      ", \"mean_ns\": %.1f, \"p50_ns\": %" G_GINT64_FORMAT ", \"p99_ns\": %" G_GINT64_FORMAT
+      ", \"max_ns\": %" G_GINT64_FORMAT ", \"throughput\": %.1f, \"unit\": \"%s\"}\n",
+      name, samples->len, total, mean, p50, p99, max, throughput, unit);
+}
+
+static GPtrArray *load_words_get_bucket (LoadWords *words, guint length, gchar first_letter)
+{
+  if (length >= G_N_ELEMENTS(words->buckets) || first_letter < 'a' || first_letter > 'z') {
+    return NULL;
+  }
+
+  return words->buckets[length][first_letter - 'a'];
+}
+
+/*
+ * Returns: (transfer full): words of the word list as typed by players, by
+ * length and first letter
+ */
+static LoadWords *load_words_new (void)
+{
+  const gchar *uri = g_getenv("MUTTUM_DICTIONARY_URI");
+  if (!uri) {
+    g_error("MUTTUM_DICTIONARY_URI must be set");
+  }
+
+  g_autoptr(GFile) file = g_file_new_for_uri(uri);
+  g_autoptr(GError) error = NULL;
+  g_autofree gchar *contents = NULL;
+
+  if (!g_file_load_contents(file, NULL, &contents, NULL, NULL, &error)) {
+    g_error("Unable to read word list: %s", error->message);
+  }
+
+  LoadWords *words = g_new0(LoadWords, 1);
+  for (guint length = 0; length < G_N_ELEMENTS(words->buckets); length += 1) {
+    for (guint letter = 0; letter < 26; letter += 1) {
+      words->buckets[length][letter] = g_ptr_array_new_with_free_func(g_free);
+    }
+  }
+
+  g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+  for (guint i = 0; lines[i]; i += 1) {
+    g_autofree gchar *ascii = g_str_to_ascii(lines[i], "C");
+    gchar *word = g_ascii_strdown(ascii, -1);
+    gsize length = strlen(word);
+    gboolean is_playable = length >= 5 && length <= 8 && word[1] != word[0];
+
+    for (gsize j = 0; j < length && is_playable; j += 1) {
+      is_playable = word[j] >= 'a' && word[j] <= 'z';
+    }
+
+    if (is_playable) {
+      g_ptr_array_add(load_words_get_bucket(words, length, word[0]), word);
+    } else {
+      g_free(word);
+    }
+  }
+
+  return words;
+}
+
+static void load_words_free (LoadWords *words)
+{
+  for (guint length = 0; length < G_N_ELEMENTS(words->buckets); length += 1) {
+    for (guint letter = 0; letter < 26; letter += 1) {
+      g_ptr_array_unref(words->buckets[length][letter]);
+    }
+  }
+  g_free(words);
+}
+
+/*
+ * Sends @command and reads its answer.
+ *
+ * Returns: (transfer full): the answer line
+ */
+static gchar *load_request (
+    GDataInputStream *input,
+    GOutputStream *output,
+    const gchar *command)
+{
+  g_autoptr(GError) error = NULL;
+
+  if (!g_output_stream_write_all(output, command, strlen(command), NULL, NULL, &error)) {
+    g_error("Unable to send a command: %s", error->message);
+  }
+
+  gchar *answer = g_data_input_stream_read_line(input, NULL, NULL, &error);
+  if (!answer) {
+    g_error("Unable to read an answer: %s", error ? error->message : "connection closed");
+  }
+
+  return answer;
+}
+
+static void load_session_new (
+    LoadSession *session,
+    GDataInputStream *input,
+    GOutputStream *output)
+{
+  g_autofree gchar *answer = load_request(input, output, "new\n");
+
+  if (sscanf(answer, "game %u %u %c", &session->id, &session->length, &session->first_letter) != 3) {
+    g_error("Unexpected answer: %s", answer);
+  }
+  session->n_rejected = 0;
+}
+
+/*
+ * Plays one guess of @session. Returns %TRUE once the session is over.
+ */
+static gboolean load_session_play (
+    LoadClient *client,
+    LoadSession *session,
+    GDataInputStream *input,
+    GOutputStream *output)
+{
+  GPtrArray *bucket = load_words_get_bucket(client->words, session->length, session->first_letter);
+
+  if (!bucket || bucket->len == 0 || session->n_rejected >= LOAD_REJECTED_MAX) {
+    g_autofree gchar *end = g_strdup_printf("end %u\n", session->id);
+    g_free(load_request(input, output, end));
+    client->n_abandoned += 1;
+    return TRUE;
+  }
+
+  const gchar *guess = g_ptr_array_index(bucket, g_rand_int_range(client->rand, 0, bucket->len));
+  g_autofree gchar *command = g_strdup_printf("guess %u %s\n", session->id, guess);
+
+  gint64 start = load_now();
+  g_autofree gchar *answer = load_request(input, output, command);
+  gint64 duration = load_now() - start;
+  g_array_append_val(client->guess_samples, duration);
+
+  if (g_str_has_prefix(answer, "error")) {
+    session->n_rejected += 1;
+    return FALSE;
+  }
+
+  session->n_rejected = 0;
+  if (g_strrstr(answer, " continue")) {
+    return FALSE;
+  }
+
+  g_autofree gchar *end = g_strdup_printf("end %u\n", session->id);
+  g_free(load_request(input, output, end));
+  client->n_played += 1;
+
+  return TRUE;
+}
+
+/*
+ * Keeps @n_sessions games open on one connection, guesses are played on
+ * each of them in turn until @n_games games are over.
+ */
+static gpointer load_client_run (gpointer data)
+{
+  LoadClient *client = data;
+  g_autoptr(GError) error = NULL;
+  g_autoptr(GSocketClient) socket_client = g_socket_client_new();
+  g_autoptr(GSocketAddress) address = g_unix_socket_address_new(client->socket_path);
+  g_autoptr(GSocketConnection) connection = g_socket_client_connect(socket_client,
+      G_SOCKET_CONNECTABLE(address), NULL, &error);
+
+  if (!connection) {
+    g_error("Unable to connect to %s: %s", client->socket_path, error->message);
+  }
+
+  g_autoptr(GDataInputStream) input = g_data_input_stream_new(
+      g_io_stream_get_input_stream(G_IO_STREAM(connection)));
+  GOutputStream *output = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+  g_autofree LoadSession *sessions = g_new0(LoadSession, client->n_sessions);
+  guint n_started = 0;
+  guint n_open = 0;
+
+  for (; n_open < client->n_sessions && n_started < client->n_games; n_open += 1, n_started += 1) {
+    load_session_new(&sessions[n_open], input, output);
+  }
+
+  while (n_open > 0) {
+    for (guint i = 0; i < n_open;) {
+      if (!load_session_play(client, &sessions[i], input, output)) {
+        i += 1;
+      } else if (n_started < client->n_games) {
+        load_session_new(&sessions[i], input, output);
+        n_started += 1;
+      } else {
+        n_open -= 1;
+        sessions[i] = sessions[n_open];
+      }
+    }
+  }
+
+  g_output_stream_write_all(output, "quit\n", 5, NULL, NULL, NULL);
+
+  return NULL;
+}
+
+/*
+ * Starts @server_path on @socket_path and waits until it's listening.
+ */
+static GSubprocess *load_server_start (const gchar *server_path, const gchar *socket_path)
+{
+  g_autoptr(GError) error = NULL;
+  GSubprocess *server = g_subprocess_new(G_SUBPROCESS_FLAGS_STDOUT_PIPE, &error,
+      server_path, "--socket", socket_path, NULL);
+
+  if (!server) {
+    g_error("Unable to start %s: %s", server_path, error->message);
+  }
+
+  g_autoptr(GDataInputStream) output = g_data_input_stream_new(g_subprocess_get_stdout_pipe(server));
+  g_autofree gchar *line = g_data_input_stream_read_line(output, NULL, NULL, &error);
+  if (!line || !g_str_has_prefix(line, "listening")) {
+    g_error("%s didn't start", server_path);
+  }
+
+  return server;
+}
+
+int main (int argc, char *argv[])
+{
+  g_autoptr(GOptionContext) context = NULL;
+  g_autoptr(GError) error = NULL;
+  gint n_clients = 0;
+  gint n_sessions = 64;
+  gint n_games = 2000;
+
+  GOptionEntry entries[] = {
+    { "clients", 'c', 0, G_OPTION_ARG_INT, &n_clients, "Number of connections (default: one by core)", "N" },
+    { "sessions", 's', 0, G_OPTION_ARG_INT, &n_sessions, "Games kept open by each connection", "N" },
+    { "games", 'g', 0, G_OPTION_ARG_INT, &n_games, "Games played by each connection", "N" },
+    { NULL },
+  };
+
+  context = g_option_context_new("SERVER - load muttum-server with concurrent games");
+  g_option_context_add_main_entries(context, entries, NULL);
+  if (!g_option_context_parse(context, &argc, &argv, &error) || argc != 2) {
+    g_printerr("%s\n", error ? error->message : "Usage: muttum-server-load [OPTION…] SERVER");
+    return EXIT_FAILURE;
+  }
+
+  if (n_clients <= 0) {
+    n_clients = g_get_num_processors();
+  }
+
+  LoadWords *words = load_words_new();
+  g_autofree gchar *directory = g_dir_make_tmp("muttum-server-XXXXXX", &error);
+  if (!directory) {
+    g_error("Unable to create a socket directory: %s", error->message);
+  }
+  g_autofree gchar *socket_path = g_build_filename(directory, "muttum.sock", NULL);
+  g_autoptr(GSubprocess) server = load_server_start(argv[1], socket_path);
+
+  LoadClient *clients = g_new0(LoadClient, n_clients);
+  GThread **threads = g_new0(GThread *, n_clients);
+
+  gint64 start = load_now();
+  for (gint i = 0; i < n_clients; i += 1) {
+    clients[i].socket_path = socket_path;
+    clients[i].words = words;
+    clients[i].n_sessions = MAX(n_sessions, 1);
+    clients[i].n_games = MAX(n_games, 1);
+    clients[i].rand = g_rand_new_with_seed(LOAD_SEED + i);
+    clients[i].guess_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+    threads[i] = g_thread_new("muttum-load", load_client_run, &clients[i]);
+  }
+
+  g_autoptr(GArray) guess_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  guint n_played = 0;
+  guint n_abandoned = 0;
+  for (gint i = 0; i < n_clients; i += 1) {
+    g_thread_join(threads[i]);
+    g_array_append_vals(guess_samples, clients[i].guess_samples->data, clients[i].guess_samples->len);
+    n_played += clients[i].n_played;
+    n_abandoned += clients[i].n_abandoned;
+    g_array_unref(clients[i].guess_samples);
+    g_rand_free(clients[i].rand);
+  }
+  gint64 duration = load_now() - start;
+
+  g_subprocess_send_signal(server, SIGTERM);
+  g_subprocess_wait(server, NULL, NULL);
+  g_rmdir(directory);
+
+  gint64 guess_total = 0;
+  for (guint i = 0; i < guess_samples->len; i += 1) {
+    guess_total += g_array_index(guess_samples, gint64, i);
+  }
+
+  // Sessions are measured as a whole, the only sample is the whole run
+  g_autoptr(GArray) session_samples = g_array_new(FALSE, FALSE, sizeof(gint64));
+  g_array_append_val(session_samples, duration);
+  load_report("server-sessions", session_samples, duration, n_played + n_abandoned, "sessions/s");
+  load_report("server-validate", guess_samples, guess_total, guess_samples->len, "guesses/s");
+  g_printerr("clients %d  played %u  abandoned %u\n", n_clients, n_played, n_abandoned);
+
+  g_free(threads);
+  g_free(clients);
+  load_words_free(words);
+
+  return EXIT_SUCCESS;
+}
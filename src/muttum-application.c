@@ -16,6 +16,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <errno.h>
+#include <glib/gstdio.h>
+
 #include "muttum-application.h"
 #include "muttum-window.h"
 
@@ -44,6 +47,79 @@ muttum_application_finalize (GObject *object)
   G_OBJECT_CLASS (muttum_application_parent_class)->finalize (object);
 }
 
+/*
+ * The game in progress when the application is closed is resumed by the
+ * next start.
+ */
+static gchar *
+muttum_application_get_saved_game_path (void)
+{
+  return g_build_filename (g_get_user_data_dir (), "muttum", "last-game.muttumsave", NULL);
+}
+
+static GBytes *
+muttum_application_load_game (void)
+{
+  g_autofree gchar *path = muttum_application_get_saved_game_path ();
+  g_autoptr(GError) error = NULL;
+  gchar *contents = NULL;
+  gsize length = 0;
+
+  if (!g_file_get_contents (path, &contents, &length, &error))
+    {
+      if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+        g_warning ("Unable to load the last game: %s", error->message);
+      return NULL;
+    }
+
+  return g_bytes_new_take (contents, length);
+}
+
+static void
+muttum_application_save_game (GtkWindow *window)
+{
+  g_autofree gchar *path = muttum_application_get_saved_game_path ();
+  g_autoptr(GError) error = NULL;
+  MuttumEngine *engine = muttum_window_get_engine (MUTTUM_WINDOW (window));
+
+  /* Window closed while its engine is created, the saved game is kept */
+  if (engine == NULL)
+    return;
+
+  /* Finished games aren't resumed */
+  if (muttum_engine_get_game_state (engine) != MUTTUM_ENGINE_STATE_CONTINUE)
+    {
+      g_remove (path);
+      return;
+    }
+
+  g_autoptr(GBytes) bytes = muttum_engine_serialize (engine);
+
+  /* Boards too large for a save aren't resumed, an older save would be */
+  if (bytes == NULL)
+    {
+      g_remove (path);
+      return;
+    }
+
+  g_autofree gchar *dir = g_path_get_dirname (path);
+  gsize size = 0;
+  const gchar *data = g_bytes_get_data (bytes, &size);
+
+  if (g_mkdir_with_parents (dir, 0700) != 0
+      || !g_file_set_contents (path, data, size, &error))
+    g_warning ("Unable to save the game: %s",
+               error ? error->message : g_strerror (errno));
+}
+
+static gboolean
+muttum_application_on_close_request (GtkWindow *window,
+                                     G_GNUC_UNUSED gpointer user_data)
+{
+  muttum_application_save_game (window);
+  return FALSE;
+}
+
 static void
 muttum_application_activate (GApplication *app)
 {
@@ -58,9 +134,15 @@ muttum_application_activate (GApplication *app)
   /* Get the current window or create one if necessary. */
   window = gtk_application_get_active_window (GTK_APPLICATION (app));
   if (window == NULL)
-    window = g_object_new (MUTTUM_TYPE_WINDOW,
-                           "application", app,
-                           NULL);
+    {
+      g_autoptr(GBytes) saved_game = muttum_application_load_game ();
+
+      window = g_object_new (MUTTUM_TYPE_WINDOW,
+                             "application", app,
+                             "saved-game", saved_game,
+                             NULL);
+      g_signal_connect (window, "close-request", G_CALLBACK (muttum_application_on_close_request), NULL);
+    }
 
   /* Ask the window manager/compositor to present the window. */
   gtk_window_present (window);
@@ -105,11 +187,26 @@ muttum_application_show_about (G_GNUC_UNUSED GSimpleAction *action,
 }
 
 
+static void
+muttum_application_quit (G_GNUC_UNUSED GSimpleAction *action,
+                         G_GNUC_UNUSED GVariant      *parameter,
+                         gpointer       user_data)
+{
+  MuttumApplication *self = MUTTUM_APPLICATION (user_data);
+  GtkWindow *window = gtk_application_get_active_window (GTK_APPLICATION (self));
+
+  /* Quitting doesn't emit GtkWindow::close-request */
+  if (window != NULL)
+    muttum_application_save_game (window);
+
+  g_application_quit (G_APPLICATION (self));
+}
+
 static void
 muttum_application_init (MuttumApplication *self)
 {
   GSimpleAction *quit_action = g_simple_action_new ("quit", NULL);
-  g_signal_connect_swapped (quit_action, "activate", G_CALLBACK (g_application_quit), self);
+  g_signal_connect (quit_action, "activate", G_CALLBACK (muttum_application_quit), self);
   g_action_map_add_action (G_ACTION_MAP (self), G_ACTION (quit_action));
 
   GSimpleAction *about_action = g_simple_action_new ("about", NULL);
@@ -0,0 +1,476 @@
+/* muttum-automaton.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "muttum-automaton.h"
+
+#define MUTTUM_AUTOMATON_NO_NODE G_MAXUINT32
+
+/*
+ * Frozen automaton: node edges are stored contiguously, sorted by symbol,
+ * in two parallel arrays so looking for a symbol only scans bytes.
+ * */
+typedef struct {
+  guint32 first_edge;
+  // Number of words accepted from this node
+  guint32 count;
+  guint16 n_edges;
+  guint8 is_final;
+} MuttumAutomatonNode;
+
+struct _MuttumAutomaton {
+  MuttumAutomatonNode *nodes;
+  guint n_nodes;
+  guint8 *edge_symbols;
+  guint32 *edge_targets;
+  // Rank of the first word reached through each edge, relative to its node
+  guint32 *edge_ranks;
+  guint n_edges;
+};
+
+/*
+ * Builder from the incremental construction algorithm for sorted input of
+ * Daciuk, Mihov, Watson & Watson: once a word is added, suffixes of the
+ * previous word which aren't shared anymore are merged with equivalent
+ * nodes from the register.
+ * */
+typedef struct {
+  guint32 target;
+  // Next edge of the same node, edges of a node are chained by symbol
+  guint32 next;
+  guint8 symbol;
+} BuildEdge;
+
+typedef struct {
+  guint32 first_edge;
+  guint32 last_edge;
+  guint32 n_edges;
+  gboolean is_final;
+} BuildNode;
+
+struct _MuttumAutomatonBuilder {
+  // Nodes and edges are appended to two arrays and referenced by index,
+  // instead of a few allocations by node. Merged nodes are left unused.
+  GArray *nodes;
+  GArray *edges;
+  // Node signature -> node id of minimized nodes
+  GHashTable *minimized;
+  // Node ids along the last added word, root first
+  GArray *path;
+  GByteArray *previous;
+  gboolean has_previous;
+};
+
+static inline BuildNode *muttum_automaton_builder_get_node (
+    MuttumAutomatonBuilder *builder,
+    guint32 node_id)
+{
+  return &g_array_index(builder->nodes, BuildNode, node_id);
+}
+
+static inline BuildEdge *muttum_automaton_builder_get_edge (
+    MuttumAutomatonBuilder *builder,
+    guint32 edge_id)
+{
+  return &g_array_index(builder->edges, BuildEdge, edge_id);
+}
+
+static guint32 muttum_automaton_builder_new_node (MuttumAutomatonBuilder *builder)
+{
+  BuildNode node = { MUTTUM_AUTOMATON_NO_NODE, MUTTUM_AUTOMATON_NO_NODE, 0, FALSE };
+  g_array_append_val(builder->nodes, node);
+  return builder->nodes->len - 1;
+}
+
+/*
+ * Appends an edge to @node_id, after its other edges.
+ */
+static void muttum_automaton_builder_add_edge (
+    MuttumAutomatonBuilder *builder,
+    guint32 node_id,
+    guint8 symbol,
+    guint32 target)
+{
+  BuildEdge edge = { target, MUTTUM_AUTOMATON_NO_NODE, symbol };
+  guint32 edge_id = builder->edges->len;
+  g_array_append_val(builder->edges, edge);
+
+  BuildNode *node = muttum_automaton_builder_get_node(builder, node_id);
+  if (node->n_edges == 0) {
+    node->first_edge = edge_id;
+  } else {
+    muttum_automaton_builder_get_edge(builder, node->last_edge)->next = edge_id;
+  }
+  node->last_edge = edge_id;
+  node->n_edges += 1;
+}
+
+MuttumAutomatonBuilder *muttum_automaton_builder_new (void)
+{
+  MuttumAutomatonBuilder *builder = g_new(MuttumAutomatonBuilder, 1);
+  builder->nodes = g_array_new(FALSE, FALSE, sizeof(BuildNode));
+  builder->edges = g_array_new(FALSE, FALSE, sizeof(BuildEdge));
+  builder->minimized = g_hash_table_new_full(g_bytes_hash, g_bytes_equal,
+      (GDestroyNotify) g_bytes_unref, NULL);
+  builder->path = g_array_new(FALSE, FALSE, sizeof(guint32));
+  builder->previous = g_byte_array_new();
+  builder->has_previous = FALSE;
+
+  guint32 root = muttum_automaton_builder_new_node(builder);
+  g_array_append_val(builder->path, root);
+
+  return builder;
+}
+
+static GBytes *muttum_automaton_build_node_signature (
+    MuttumAutomatonBuilder *builder,
+    guint32 node_id)
+{
+  BuildNode *node = muttum_automaton_builder_get_node(builder, node_id);
+  GByteArray *signature = g_byte_array_sized_new(1 + node->n_edges * 5);
+  guint8 is_final = node->is_final;
+
+  g_byte_array_append(signature, &is_final, 1);
+  for (guint32 edge_id = node->first_edge; edge_id != MUTTUM_AUTOMATON_NO_NODE; ) {
+    BuildEdge *edge = muttum_automaton_builder_get_edge(builder, edge_id);
+    edge_id = edge->next;
+    g_byte_array_append(signature, &edge->symbol, 1);
+    g_byte_array_append(signature, (const guint8 *) &edge->target, sizeof(edge->target));
+  }
+
+  return g_byte_array_free_to_bytes(signature);
+}
+
+/*
+ * Merges nodes of the last word deeper than @depth with their equivalent
+ * minimized node, or registers them as minimized.
+ */
+static void muttum_automaton_builder_minimize (
+    MuttumAutomatonBuilder *builder,
+    guint depth)
+{
+  for (guint i = builder->path->len - 1; i > depth; i -= 1) {
+    guint32 child = g_array_index(builder->path, guint32, i);
+    BuildNode *parent = muttum_automaton_builder_get_node(builder, g_array_index(builder->path, guint32, i - 1));
+    GBytes *signature = muttum_automaton_build_node_signature(builder, child);
+    gpointer equivalent = NULL;
+
+    if (g_hash_table_lookup_extended(builder->minimized, signature, NULL, &equivalent)) {
+      // Input is sorted: child is always reached by the last edge of its parent
+      muttum_automaton_builder_get_edge(builder, parent->last_edge)->target = GPOINTER_TO_UINT(equivalent);
+      g_bytes_unref(signature);
+    } else {
+      g_hash_table_insert(builder->minimized, signature, GUINT_TO_POINTER(child));
+    }
+  }
+
+  g_array_set_size(builder->path, depth + 1);
+}
+
+/*
+ * muttum_automaton_builder_add:
+ * @symbols: the word to add, words must be added in strictly increasing
+ *   lexicographic order
+ */
+void muttum_automaton_builder_add (
+    MuttumAutomatonBuilder *builder,
+    const guint8 *symbols,
+    gsize n_symbols)
+{
+  gsize prefix = 0;
+  while (prefix < n_symbols && prefix < builder->previous->len
+      && symbols[prefix] == builder->previous->data[prefix]) {
+    prefix += 1;
+  }
+
+  // Rejects duplicates and unsorted input
+  g_return_if_fail(!builder->has_previous
+      || (prefix < n_symbols
+        && (prefix == builder->previous->len || symbols[prefix] > builder->previous->data[prefix])));
+
+  muttum_automaton_builder_minimize(builder, prefix);
+
+  guint32 node = g_array_index(builder->path, guint32, prefix);
+  for (gsize i = prefix; i < n_symbols; i += 1) {
+    guint32 next = muttum_automaton_builder_new_node(builder);
+    muttum_automaton_builder_add_edge(builder, node, symbols[i], next);
+    g_array_append_val(builder->path, next);
+    node = next;
+  }
+  muttum_automaton_builder_get_node(builder, node)->is_final = TRUE;
+
+  g_byte_array_set_size(builder->previous, 0);
+  g_byte_array_append(builder->previous, symbols, n_symbols);
+  builder->has_previous = TRUE;
+}
+
+static guint32 muttum_automaton_builder_count (
+    MuttumAutomatonBuilder *builder,
+    guint32 node_id,
+    guint32 *counts)
+{
+  if (counts[node_id] != MUTTUM_AUTOMATON_NO_NODE) {
+    return counts[node_id];
+  }
+
+  guint32 count = muttum_automaton_builder_get_node(builder, node_id)->is_final ? 1 : 0;
+  guint32 edge_id = muttum_automaton_builder_get_node(builder, node_id)->first_edge;
+  while (edge_id != MUTTUM_AUTOMATON_NO_NODE) {
+    BuildEdge *edge = muttum_automaton_builder_get_edge(builder, edge_id);
+    count += muttum_automaton_builder_count(builder, edge->target, counts);
+    edge_id = edge->next;
+  }
+
+  counts[node_id] = count;
+  return count;
+}
+
+/*
+ * muttum_automaton_builder_finish:
+ *
+ * Minimizes remaining nodes and freezes the automaton, root gets id 0.
+ *
+ * Returns: (transfer full): the automaton, @builder is freed
+ */
+MuttumAutomaton *muttum_automaton_builder_finish (MuttumAutomatonBuilder *builder)
+{
+  muttum_automaton_builder_minimize(builder, 0);
+
+  guint n_build_nodes = builder->nodes->len;
+  guint32 *counts = g_new(guint32, n_build_nodes);
+  guint32 *new_ids = g_new(guint32, n_build_nodes);
+  memset(counts, 0xff, n_build_nodes * sizeof(guint32));
+  memset(new_ids, 0xff, n_build_nodes * sizeof(guint32));
+
+  muttum_automaton_builder_count(builder, 0, counts);
+
+  // Breadth first numbering of reachable nodes
+  GArray *order = g_array_new(FALSE, FALSE, sizeof(guint32));
+  guint n_edges = 0;
+  guint32 root = 0;
+  new_ids[root] = 0;
+  g_array_append_val(order, root);
+  for (guint i = 0; i < order->len; i += 1) {
+    BuildNode *node = muttum_automaton_builder_get_node(builder, g_array_index(order, guint32, i));
+    for (guint32 edge_id = node->first_edge; edge_id != MUTTUM_AUTOMATON_NO_NODE; ) {
+      BuildEdge *edge = muttum_automaton_builder_get_edge(builder, edge_id);
+      guint32 target = edge->target;
+      edge_id = edge->next;
+      if (new_ids[target] == MUTTUM_AUTOMATON_NO_NODE) {
+        new_ids[target] = order->len;
+        g_array_append_val(order, target);
+      }
+    }
+    n_edges += node->n_edges;
+  }
+
+  MuttumAutomaton *automaton = g_new(MuttumAutomaton, 1);
+  automaton->n_nodes = order->len;
+  automaton->n_edges = n_edges;
+  automaton->nodes = g_new(MuttumAutomatonNode, order->len);
+  automaton->edge_symbols = g_new(guint8, n_edges);
+  automaton->edge_targets = g_new(guint32, n_edges);
+  automaton->edge_ranks = g_new(guint32, n_edges);
+
+  guint edge = 0;
+  for (guint i = 0; i < order->len; i += 1) {
+    guint32 build_id = g_array_index(order, guint32, i);
+    BuildNode *node = muttum_automaton_builder_get_node(builder, build_id);
+    MuttumAutomatonNode *frozen = &automaton->nodes[i];
+    guint32 rank = node->is_final ? 1 : 0;
+
+    frozen->first_edge = edge;
+    frozen->n_edges = node->n_edges;
+    frozen->is_final = node->is_final;
+    frozen->count = counts[build_id];
+
+    for (guint32 edge_id = node->first_edge; edge_id != MUTTUM_AUTOMATON_NO_NODE; edge += 1) {
+      BuildEdge *build_edge = muttum_automaton_builder_get_edge(builder, edge_id);
+      automaton->edge_symbols[edge] = build_edge->symbol;
+      automaton->edge_targets[edge] = new_ids[build_edge->target];
+      automaton->edge_ranks[edge] = rank;
+      rank += counts[build_edge->target];
+      edge_id = build_edge->next;
+    }
+  }
+
+  g_array_unref(order);
+  g_free(new_ids);
+  g_free(counts);
+
+  g_byte_array_unref(builder->previous);
+  g_array_unref(builder->path);
+  g_hash_table_unref(builder->minimized);
+  g_array_unref(builder->edges);
+  g_array_unref(builder->nodes);
+  g_free(builder);
+
+  return automaton;
+}
+
+void muttum_automaton_free (MuttumAutomaton *automaton)
+{
+  if (!automaton) {
+    return;
+  }
+
+  g_free(automaton->edge_ranks);
+  g_free(automaton->edge_targets);
+  g_free(automaton->edge_symbols);
+  g_free(automaton->nodes);
+  g_free(automaton);
+}
+
+guint muttum_automaton_get_n_words (MuttumAutomaton *automaton)
+{
+  return automaton->nodes[0].count;
+}
+
+/*
+ * muttum_automaton_get_size:
+ *
+ * Returns: number of bytes used by the frozen automaton
+ */
+gsize muttum_automaton_get_size (MuttumAutomaton *automaton)
+{
+  return sizeof(MuttumAutomaton)
+    + automaton->n_nodes * sizeof(MuttumAutomatonNode)
+    + automaton->n_edges * (sizeof(guint8) + 2 * sizeof(guint32));
+}
+
+/*
+ * Follows @symbols from the root, adding ranks of words skipped on the way.
+ *
+ * Returns: the reached node or %MUTTUM_AUTOMATON_NO_NODE
+ */
+static guint32 muttum_automaton_walk (
+    MuttumAutomaton *automaton,
+    const guint8 *symbols,
+    gsize n_symbols,
+    guint *rank)
+{
+  guint32 node = 0;
+  *rank = 0;
+
+  for (gsize i = 0; i < n_symbols; i += 1) {
+    const MuttumAutomatonNode *current = &automaton->nodes[node];
+    const guint8 *edges = automaton->edge_symbols + current->first_edge;
+    const guint8 *found = memchr(edges, symbols[i], current->n_edges);
+
+    if (!found) {
+      return MUTTUM_AUTOMATON_NO_NODE;
+    }
+
+    guint edge = current->first_edge + (found - edges);
+    *rank += automaton->edge_ranks[edge];
+    node = automaton->edge_targets[edge];
+  }
+
+  return node;
+}
+
+/*
+ * muttum_automaton_lookup:
+ *
+ * Returns: the rank of the word or -1 when it isn't accepted
+ */
+gint64 muttum_automaton_lookup (
+    MuttumAutomaton *automaton,
+    const guint8 *symbols,
+    gsize n_symbols)
+{
+  guint rank = 0;
+  guint32 node = muttum_automaton_walk(automaton, symbols, n_symbols, &rank);
+
+  if (node == MUTTUM_AUTOMATON_NO_NODE || !automaton->nodes[node].is_final) {
+    return -1;
+  }
+
+  return rank;
+}
+
+/*
+ * muttum_automaton_get_prefix_range:
+ * @first_rank: (out): rank of the first word starting with @prefix
+ * @n_words: (out): number of words starting with @prefix
+ *
+ * Words starting with the same prefix have consecutive ranks.
+ *
+ * Returns: %FALSE when no word starts with @prefix
+ */
+gboolean muttum_automaton_get_prefix_range (
+    MuttumAutomaton *automaton,
+    const guint8 *prefix,
+    gsize n_symbols,
+    guint *first_rank,
+    guint *n_words)
+{
+  guint rank = 0;
+  guint32 node = muttum_automaton_walk(automaton, prefix, n_symbols, &rank);
+
+  if (node == MUTTUM_AUTOMATON_NO_NODE) {
+    *first_rank = 0;
+    *n_words = 0;
+    return FALSE;
+  }
+
+  *first_rank = rank;
+  *n_words = automaton->nodes[node].count;
+  return TRUE;
+}
+
+/*
+ * muttum_automaton_get_word:
+ * @rank: rank of the word, below muttum_automaton_get_n_words()
+ * @symbols: (out caller-allocates): filled with the symbols of the word
+ * @size: number of symbols @symbols can hold
+ *
+ * Inverse of muttum_automaton_lookup(): each node is left through the last
+ * edge whose rank isn't above the remaining rank.
+ *
+ * Returns: number of symbols of the word, 0 if @rank or @size is out of range
+ */
+gsize muttum_automaton_get_word (
+    MuttumAutomaton *automaton,
+    guint rank,
+    guint8 *symbols,
+    gsize size)
+{
+  g_return_val_if_fail(rank < muttum_automaton_get_n_words(automaton), 0);
+
+  guint32 node = 0;
+  gsize n_symbols = 0;
+
+  while (!automaton->nodes[node].is_final || rank > 0) {
+    const MuttumAutomatonNode *current = &automaton->nodes[node];
+    guint edge = current->first_edge;
+    guint last_edge = current->first_edge + current->n_edges - 1;
+
+    while (edge < last_edge && automaton->edge_ranks[edge + 1] <= rank) {
+      edge += 1;
+    }
+
+    g_return_val_if_fail(n_symbols < size, 0);
+    symbols[n_symbols++] = automaton->edge_symbols[edge];
+    rank -= automaton->edge_ranks[edge];
+    node = automaton->edge_targets[edge];
+  }
+
+  return n_symbols;
+}
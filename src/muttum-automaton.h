@@ -0,0 +1,66 @@
+/* muttum-automaton.h
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Minimized acyclic automaton (DAWG) over byte symbols.
+ *
+ * Words are numbered by their rank in lexicographic order, so callers can
+ * keep per word data in plain arrays indexed by rank.
+ * */
+
+typedef struct _MuttumAutomaton MuttumAutomaton;
+typedef struct _MuttumAutomatonBuilder MuttumAutomatonBuilder;
+
+MuttumAutomatonBuilder *muttum_automaton_builder_new (void);
+
+void muttum_automaton_builder_add (MuttumAutomatonBuilder *builder,
+                                   const guint8 *symbols,
+                                   gsize n_symbols);
+
+MuttumAutomaton *muttum_automaton_builder_finish (MuttumAutomatonBuilder *builder);
+
+void muttum_automaton_free (MuttumAutomaton *automaton);
+
+guint muttum_automaton_get_n_words (MuttumAutomaton *automaton);
+
+gsize muttum_automaton_get_size (MuttumAutomaton *automaton);
+
+gint64 muttum_automaton_lookup (MuttumAutomaton *automaton,
+                                const guint8 *symbols,
+                                gsize n_symbols);
+
+gboolean muttum_automaton_get_prefix_range (MuttumAutomaton *automaton,
+                                            const guint8 *prefix,
+                                            gsize n_symbols,
+                                            guint *first_rank,
+                                            guint *n_words);
+
+gsize muttum_automaton_get_word (MuttumAutomaton *automaton,
+                                 guint rank,
+                                 guint8 *symbols,
+                                 gsize size);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MuttumAutomaton, muttum_automaton_free)
+
+G_END_DECLS
@@ -0,0 +1,565 @@
+/* muttum-cli.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "muttum.h"
+
+/*
+ * Headless game runner, it only uses the public MuttumEngine API.
+ *
+ * Without --bulk, games are played from commands read on the standard input
+ * or in the --script file, one by line:
+ *   WORD   type and validate WORD on the current row
+ *   board  print the board
+ *   word   print the word to find
+ *   hint   print the guess suggested by the solver
+ *   candidates  print the words still consistent with the board
+ *   new    start a new game
+ *   quit   stop reading commands
+ *
+ * With --bulk, games are played back to back with guesses taken from the
+ * --words list, then the throughput and the latency of each engine
+ * operation are reported.
+ *
+ * --rows, --length-min and --length-max change the board geometry.
+ * */
+
+#define MUTTUM_CLI_LINE_SIZE 256
+#define MUTTUM_CLI_BULK_SEED 42
+
+typedef enum {
+	MUTTUM_CLI_OP_NEW_GAME,
+	MUTTUM_CLI_OP_BOARD_STATE,
+	MUTTUM_CLI_OP_ADD_LETTER,
+	MUTTUM_CLI_OP_REMOVE_LETTER,
+	MUTTUM_CLI_OP_VALIDATE,
+	MUTTUM_CLI_N_OPS,
+} MuttumCliOp;
+
+static const gchar *muttum_cli_op_names[MUTTUM_CLI_N_OPS] = {
+	"new-game",
+	"board-state",
+	"add-letter",
+	"remove-letter",
+	"validate",
+};
+
+// Board geometry of the command line, 0 keeps the engine default
+static gint muttum_cli_rows = 0;
+static gint muttum_cli_length_min = 0;
+static gint muttum_cli_length_max = 0;
+
+/*
+ * Returns: %FALSE if @value is given but out of [@min, @max], the engine
+ * would only warn and keep its default
+ */
+static gboolean
+muttum_cli_check_option (const gchar *name, gint value, gint min, gint max)
+{
+	if (value != 0 && (value < min || value > max)) {
+		g_printerr("--%s must be between %d and %d\n", name, min, max);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static MuttumEngine *
+muttum_cli_engine_new (void)
+{
+	const gchar *names[3];
+	GValue values[3] = { G_VALUE_INIT, G_VALUE_INIT, G_VALUE_INIT };
+	const gchar *option_names[3] = { "rows", "word-length-min", "word-length-max" };
+	const gint options[3] = { muttum_cli_rows, muttum_cli_length_min, muttum_cli_length_max };
+	guint n_properties = 0;
+
+	for (guint i = 0; i < G_N_ELEMENTS(options); i += 1) {
+		if (options[i] > 0) {
+			names[n_properties] = option_names[i];
+			g_value_init(&values[n_properties], G_TYPE_UINT);
+			g_value_set_uint(&values[n_properties], options[i]);
+			n_properties += 1;
+		}
+	}
+
+	GObject *engine = g_object_new_with_properties(MUTTUM_TYPE_ENGINE, n_properties, names, values);
+	for (guint i = 0; i < n_properties; i += 1) {
+		g_value_unset(&values[i]);
+	}
+
+	g_autoptr(GError) error = NULL;
+	if (!g_initable_init(G_INITABLE(engine), NULL, &error)) {
+		g_printerr("%s\n", error->message);
+		g_object_unref(engine);
+		return NULL;
+	}
+
+	return MUTTUM_ENGINE(engine);
+}
+
+static gint64
+muttum_cli_now (void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (gint64) now.tv_sec * G_GINT64_CONSTANT(1000000000) + now.tv_nsec;
+}
+
+static gint
+muttum_cli_compare_samples (gconstpointer a, gconstpointer b)
+{
+	gint64 first = *(const gint64 *) a;
+	gint64 second = *(const gint64 *) b;
+	return (first > second) - (first < second);
+}
+
+static gchar
+muttum_cli_state_symbol (MuttumLetterState state)
+{
+	switch (state) {
+	case MUTTUM_LETTER_WELL_PLACED:
+		return '+';
+	case MUTTUM_LETTER_PRESENT:
+		return '?';
+	case MUTTUM_LETTER_NOT_PRESENT:
+		return '-';
+	default:
+		return ' ';
+	}
+}
+
+/*
+ * Returns: (transfer full): @word as typed on a keyboard, or %NULL if it
+ * can't be typed with a-z letters only.
+ */
+static gchar *
+muttum_cli_fold (const gchar *word)
+{
+	g_autofree gchar *ascii = g_str_to_ascii(word, "C");
+	gchar *folded = g_ascii_strdown(ascii, -1);
+
+	for (gchar *letter = folded; *letter; letter += 1) {
+		if (*letter < 'a' || *letter > 'z') {
+			g_free(folded);
+			return NULL;
+		}
+	}
+
+	return folded;
+}
+
+static void
+muttum_cli_print_board (MuttumEngine *engine)
+{
+	guint n_rows = 0;
+	guint length = 0;
+	const MuttumLetter *board = muttum_engine_peek_board(engine, &n_rows, &length);
+
+	for (guint row_index = 0; row_index < n_rows; row_index += 1) {
+		g_autoptr(GString) letters = g_string_new(NULL);
+		g_autoptr(GString) states = g_string_new(NULL);
+
+		for (guint col = 0; col < length; col += 1) {
+			const MuttumLetter *letter = &board[row_index * length + col];
+			g_string_append_c(letters, letter->letter);
+			g_string_append_c(states, muttum_cli_state_symbol(letter->state));
+		}
+
+		g_print("%u %s %s\n", row_index + 1, letters->str, states->str);
+	}
+}
+
+static void
+muttum_cli_print_state (MuttumEngine *engine)
+{
+	g_autoptr(GString) word = NULL;
+
+	switch (muttum_engine_get_game_state(engine)) {
+	case MUTTUM_ENGINE_STATE_WON:
+		g_print("won\n");
+		break;
+	case MUTTUM_ENGINE_STATE_LOST:
+		word = muttum_engine_get_word(engine);
+		g_print("lost %s\n", word->str);
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Types @word on the current row, its first letter is already given by the
+ * engine. Returns the number of letters typed.
+ */
+static gsize
+muttum_cli_type_word (MuttumEngine *engine, const gchar *word, GArray **samples)
+{
+	gsize length = strlen(word);
+
+	for (gsize i = 1; i < length; i += 1) {
+		gint64 start = muttum_cli_now();
+		muttum_engine_add_letter(engine, word[i]);
+		gint64 duration = muttum_cli_now() - start;
+		if (samples) {
+			g_array_append_val(samples[MUTTUM_CLI_OP_ADD_LETTER], duration);
+		}
+	}
+
+	return length > 0 ? length - 1 : 0;
+}
+
+static void
+muttum_cli_erase_word (MuttumEngine *engine, gsize n_letters, GArray **samples)
+{
+	for (gsize i = 0; i < n_letters; i += 1) {
+		gint64 start = muttum_cli_now();
+		muttum_engine_remove_letter(engine);
+		gint64 duration = muttum_cli_now() - start;
+		if (samples) {
+			g_array_append_val(samples[MUTTUM_CLI_OP_REMOVE_LETTER], duration);
+		}
+	}
+}
+
+static void
+muttum_cli_play_guess (MuttumEngine *engine, const gchar *guess)
+{
+	g_autoptr(GError) error = NULL;
+	g_autofree gchar *folded = muttum_cli_fold(guess);
+
+	if (muttum_engine_get_game_state(engine) != MUTTUM_ENGINE_STATE_CONTINUE) {
+		g_print("error game is over, use \"new\"\n");
+		return;
+	}
+
+	if (!folded) {
+		g_print("error only letters are allowed\n");
+		return;
+	}
+
+	guint length = 0;
+	const MuttumLetter *board = muttum_engine_peek_board(engine, NULL, &length);
+	const MuttumLetter *first_letter = &board[muttum_engine_get_current_row(engine) * length];
+
+	if (strlen(folded) != length || folded[0] != first_letter->letter) {
+		g_print("error expected %u letters starting with %c\n", length, first_letter->letter);
+		return;
+	}
+
+	gsize n_letters = muttum_cli_type_word(engine, folded, NULL);
+	muttum_engine_validate(engine, &error);
+
+	if (error) {
+		muttum_cli_erase_word(engine, n_letters, NULL);
+		g_print("error %s\n", error->message);
+		return;
+	}
+
+	muttum_cli_print_board(engine);
+	muttum_cli_print_state(engine);
+}
+
+static int
+muttum_cli_run_script (FILE *input)
+{
+	g_autoptr(MuttumEngine) engine = muttum_cli_engine_new();
+	gchar line[MUTTUM_CLI_LINE_SIZE];
+
+	if (!engine) {
+		return EXIT_FAILURE;
+	}
+
+	muttum_cli_print_board(engine);
+
+	while (fgets(line, sizeof(line), input)) {
+		g_strstrip(line);
+
+		if (line[0] == '\0' || line[0] == '#') {
+			continue;
+		} else if (g_strcmp0(line, "quit") == 0) {
+			break;
+		} else if (g_strcmp0(line, "new") == 0) {
+			muttum_engine_reset(engine);
+			muttum_cli_print_board(engine);
+		} else if (g_strcmp0(line, "board") == 0) {
+			muttum_cli_print_board(engine);
+		} else if (g_strcmp0(line, "hint") == 0) {
+			g_autofree gchar *hint = muttum_engine_suggest_guess(engine);
+			g_print("hint %s\n", hint ? hint : "-");
+		} else if (g_strcmp0(line, "candidates") == 0) {
+			MuttumEngineCandidateIter iter;
+			const gchar *candidate = NULL;
+
+			g_print("candidates %u", muttum_engine_get_candidate_count(engine));
+			muttum_engine_candidate_iter_init(&iter, engine);
+			while (muttum_engine_candidate_iter_next(&iter, &candidate)) {
+				g_print(" %s", candidate);
+			}
+			g_print("\n");
+		} else if (g_strcmp0(line, "word") == 0) {
+			g_autoptr(GString) word = muttum_engine_get_word(engine);
+			g_print("word %s\n", word->str);
+		} else {
+			muttum_cli_play_guess(engine, line);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/*
+ * Returns: (transfer full): guesses of the @path word list which can be typed
+ */
+static GPtrArray *
+muttum_cli_load_words (const gchar *path, GError **error)
+{
+	g_autofree gchar *contents = NULL;
+	GPtrArray *words = g_ptr_array_new_with_free_func(g_free);
+
+	if (!path) {
+		return words;
+	}
+
+	if (!g_file_get_contents(path, &contents, NULL, error)) {
+		g_ptr_array_unref(words);
+		return NULL;
+	}
+
+	g_auto(GStrv) lines = g_strsplit(contents, "\n", -1);
+	for (guint i = 0; lines[i]; i += 1) {
+		gchar *word = muttum_cli_fold(g_strstrip(lines[i]));
+		// The engine ignores the first letter typed again on second position
+		if (word && strlen(word) > 1 && word[1] != word[0]) {
+			g_ptr_array_add(words, word);
+		} else {
+			g_free(word);
+		}
+	}
+
+	return words;
+}
+
+/*
+ * Plays one new game of @engine with random guesses from @words of the
+ * right first letter and length, the word to find is guessed on the last
+ * row. Returns %FALSE if the word to find can't be typed.
+ */
+static gboolean
+muttum_cli_play_bulk_game (MuttumEngine *engine, GPtrArray *words, GPtrArray *candidates, GArray **samples)
+{
+	gint64 start = muttum_cli_now();
+	muttum_engine_reset(engine);
+	gint64 duration = muttum_cli_now() - start;
+	g_array_append_val(samples[MUTTUM_CLI_OP_NEW_GAME], duration);
+
+	guint n_rows = 0;
+	guint length = 0;
+	start = muttum_cli_now();
+	const MuttumLetter *board = muttum_engine_peek_board(engine, &n_rows, &length);
+	duration = muttum_cli_now() - start;
+	g_array_append_val(samples[MUTTUM_CLI_OP_BOARD_STATE], duration);
+
+	gchar first_letter = board[0].letter;
+
+	g_autoptr(GString) word = muttum_engine_get_word(engine);
+	g_autofree gchar *answer = muttum_cli_fold(word->str);
+	if (!answer || strlen(answer) != length) {
+		return FALSE;
+	}
+
+	g_ptr_array_set_size(candidates, 0);
+	for (guint i = 0; i < words->len; i += 1) {
+		const gchar *candidate = g_ptr_array_index(words, i);
+		if (candidate[0] == first_letter && strlen(candidate) == length) {
+			g_ptr_array_add(candidates, (gpointer) candidate);
+		}
+	}
+
+	while (muttum_engine_get_game_state(engine) == MUTTUM_ENGINE_STATE_CONTINUE) {
+		g_autoptr(GError) error = NULL;
+		gboolean is_last_row = muttum_engine_get_current_row(engine) + 1 >= n_rows;
+		const gchar *guess = answer;
+
+		if (!is_last_row && candidates->len > 0) {
+			guess = g_ptr_array_index(candidates, g_random_int_range(0, candidates->len));
+		}
+
+		gsize n_letters = muttum_cli_type_word(engine, guess, samples);
+
+		start = muttum_cli_now();
+		muttum_engine_validate(engine, &error);
+		duration = muttum_cli_now() - start;
+		g_array_append_val(samples[MUTTUM_CLI_OP_VALIDATE], duration);
+
+		if (error) {
+			// The word to find itself isn't accepted, give up this game
+			if (guess == answer) {
+				return FALSE;
+			}
+			muttum_cli_erase_word(engine, n_letters, samples);
+			g_ptr_array_remove_fast(candidates, (gpointer) guess);
+		}
+	}
+
+	return TRUE;
+}
+
+static void
+muttum_cli_report_op (const gchar *name, GArray *samples)
+{
+	if (samples->len == 0) {
+		return;
+	}
+
+	gint64 total = 0;
+	for (guint i = 0; i < samples->len; i += 1) {
+		total += g_array_index(samples, gint64, i);
+	}
+
+	g_array_sort(samples, muttum_cli_compare_samples);
+
+	g_print("%-14s count %8u  mean %9.0f ns  p50 %8" G_GINT64_FORMAT " ns  p90 %8" G_GINT64_FORMAT
+	        " ns  p99 %8" G_GINT64_FORMAT " ns  max %9" G_GINT64_FORMAT " ns\n",
+	        name, samples->len,
+	        (gdouble) total / samples->len,
+	        g_array_index(samples, gint64, samples->len / 2),
+	        g_array_index(samples, gint64, samples->len * 90 / 100),
+	        g_array_index(samples, gint64, samples->len * 99 / 100),
+	        g_array_index(samples, gint64, samples->len - 1));
+}
+
+static int
+muttum_cli_run_bulk (guint n_games, const gchar *words_path)
+{
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) words = muttum_cli_load_words(words_path, &error);
+	g_autoptr(GPtrArray) candidates = g_ptr_array_new();
+	GArray *samples[MUTTUM_CLI_N_OPS];
+	guint n_played = 0;
+	guint n_skipped = 0;
+
+	if (!words) {
+		g_printerr("Unable to read word list: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	for (guint op = 0; op < MUTTUM_CLI_N_OPS; op += 1) {
+		samples[op] = g_array_new(FALSE, FALSE, sizeof(gint64));
+	}
+
+	// The engine creation loads the dictionary, it isn't part of the games
+	// which only reset the engine
+	g_autoptr(MuttumEngine) engine = muttum_cli_engine_new();
+	if (!engine) {
+		return EXIT_FAILURE;
+	}
+
+	gint64 start = muttum_cli_now();
+	for (guint game = 0; game < n_games; game += 1) {
+		if (muttum_cli_play_bulk_game(engine, words, candidates, samples)) {
+			n_played += 1;
+		} else {
+			n_skipped += 1;
+		}
+	}
+	gint64 duration = muttum_cli_now() - start;
+
+	g_print("games %u  skipped %u  elapsed %.3f s  %.1f games/s\n",
+	        n_played, n_skipped, duration / 1e9,
+	        duration > 0 ? n_games * 1e9 / duration : 0);
+
+	for (guint op = 0; op < MUTTUM_CLI_N_OPS; op += 1) {
+		muttum_cli_report_op(muttum_cli_op_names[op], samples[op]);
+		g_array_unref(samples[op]);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+	g_autoptr(GOptionContext) context = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autofree gchar *script_path = NULL;
+	g_autofree gchar *words_path = NULL;
+	gint bulk = 0;
+	gint64 seed = -1;
+
+	GOptionEntry entries[] = {
+		{ "script", 's', 0, G_OPTION_ARG_FILENAME, &script_path, "Read commands from FILE instead of the standard input", "FILE" },
+		{ "bulk", 'b', 0, G_OPTION_ARG_INT, &bulk, "Play N games back to back and report timings", "N" },
+		{ "words", 'w', 0, G_OPTION_ARG_FILENAME, &words_path, "Guesses used by bulk games (default: only the word to find)", "FILE" },
+		{ "seed", 0, 0, G_OPTION_ARG_INT64, &seed, "Seed of the word selection (default: random, fixed for bulk games)", "SEED" },
+		{ "rows", 'r', 0, G_OPTION_ARG_INT, &muttum_cli_rows, "Number of tries by game (default: 6)", "N" },
+		{ "length-min", 0, 0, G_OPTION_ARG_INT, &muttum_cli_length_min, "Shortest word to find (default: 5)", "N" },
+		{ "length-max", 0, 0, G_OPTION_ARG_INT, &muttum_cli_length_max, "Longest word to find (default: 8)", "N" },
+		{ NULL },
+	};
+
+	context = g_option_context_new("- play Muttum games without display");
+	g_option_context_add_main_entries(context, entries, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("%s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	if (!muttum_cli_check_option("rows", muttum_cli_rows, 1, MUTTUM_ENGINE_ROWS_MAX)
+	    || !muttum_cli_check_option("length-min", muttum_cli_length_min,
+	                                MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MIN, MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MAX)
+	    || !muttum_cli_check_option("length-max", muttum_cli_length_max,
+	                                MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MIN, MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MAX)) {
+		return EXIT_FAILURE;
+	}
+
+	if (muttum_cli_length_min > 0 && muttum_cli_length_max > 0
+	    && muttum_cli_length_min > muttum_cli_length_max) {
+		g_printerr("--length-min must not be greater than --length-max\n");
+		return EXIT_FAILURE;
+	}
+
+	if (seed < 0 && bulk > 0) {
+		seed = MUTTUM_CLI_BULK_SEED;
+	}
+
+	if (seed >= 0) {
+		g_random_set_seed((guint32) seed);
+	}
+
+	if (bulk > 0) {
+		return muttum_cli_run_bulk(bulk, words_path);
+	}
+
+	if (script_path) {
+		FILE *script = fopen(script_path, "r");
+		if (!script) {
+			g_printerr("Unable to open %s\n", script_path);
+			return EXIT_FAILURE;
+		}
+		int ret = muttum_cli_run_script(script);
+		fclose(script);
+		return ret;
+	}
+
+	return muttum_cli_run_script(stdin);
+}
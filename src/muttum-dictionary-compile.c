@@ -0,0 +1,56 @@
+/* muttum-dictionary-compile.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include "muttum-dictionary.h"
+
+/*
+ * Build tool writing the binary dictionary index mapped by the engine.
+ *
+ * Usage: muttum-dictionary-compile LOCALE LENGTH_MIN LENGTH_MAX WORD_LIST OUTPUT
+ * */
+int
+main (int   argc,
+      char *argv[])
+{
+	g_autoptr(GError) error = NULL;
+
+	if (argc != 6) {
+		g_printerr("Usage: %s LOCALE LENGTH_MIN LENGTH_MAX WORD_LIST OUTPUT\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	guint64 word_length_min = 0;
+	guint64 word_length_max = 0;
+	if (!g_ascii_string_to_unsigned(argv[2], 10, 1, G_MAXUINT8, &word_length_min, &error)
+	    || !g_ascii_string_to_unsigned(argv[3], 10, word_length_min, G_MAXUINT8, &word_length_max, &error)) {
+		g_printerr("Invalid word length: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	g_autoptr(GFile) source = g_file_new_for_commandline_arg(argv[4]);
+
+	if (!muttum_dictionary_index_write(source, argv[1],
+	      word_length_min, word_length_max, argv[5], &error)) {
+		g_printerr("Unable to write dictionary index: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,1519 @@
+/* muttum-dictionary.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <unicode/ustring.h>
+#include <unicode/utrans.h>
+#include <unicode/utypes.h>
+
+#include "muttum-automaton.h"
+#include "muttum-dictionary.h"
+#include "muttum-fold.h"
+
+#define MUTTUM_DICTIONARY_UCHAR_BUFFER_SIZE 100
+#define MUTTUM_DICTIONARY_SOURCE_ATTRIBUTES \
+  G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_TIME_MODIFIED
+
+// Word list chunks indexed in parallel, small lists aren't split
+#define MUTTUM_DICTIONARY_CHUNKS_BY_THREAD 4
+#define MUTTUM_DICTIONARY_CHUNK_SIZE_MIN (64 * 1024)
+
+struct _MuttumDictionaryIndex {
+  // Either the mapped index file or the index built in memory
+  GBytes *bytes;
+  const MuttumDictionaryIndexHeader *header;
+  const MuttumDictionaryIndexEntry *entries;
+  const guint32 *buckets;
+  const guint32 *positions;
+  const gchar *keys;
+  const gchar *words;
+  const guint64 *folded;
+};
+
+typedef struct {
+  guint32 rank;
+  guint32 word;
+} MuttumDictionarySpelling;
+
+struct _MuttumDictionary {
+  MuttumDictionaryBackend backend;
+
+  // Index backend
+  MuttumDictionaryIndex *index;
+
+  // Automaton backend, over the number of letters followed by the letter
+  // codes of the fold key of playable words. Only spellings which aren't
+  // their letters are stored, sorted by automaton rank.
+  MuttumAutomaton *automaton;
+  // Fold keys of the words which can be guessed but not played, they are
+  // shown with other letters than their fold key ones
+  guint64 *guess_keys;
+  guint n_guess_keys;
+  MuttumDictionarySpelling *spellings;
+  guint n_spellings;
+  gchar *spelling_words;
+  gsize spelling_words_size;
+  guint n_collapsed;
+};
+
+/*
+ * muttum_dictionary_open_collator:
+ * @locale: the ICU locale of the dictionary
+ *
+ * Returns: (transfer full): a primary strength collator, the same one is used
+ * to build the index and to validate words.
+ */
+UCollator *muttum_dictionary_open_collator (const gchar *locale)
+{
+  UErrorCode status = U_ZERO_ERROR;
+  UCollator *collator = ucol_open(locale, &status);
+
+  if (U_FAILURE(status)) {
+    g_error("Unable to open unicode collator");
+  }
+
+  // Primary strength allow to work with only base characters
+  // (neither case sensitive, nor accent sensitive)
+  ucol_setStrength(collator, UCOL_PRIMARY);
+
+  return collator;
+}
+
+/*
+ * muttum_dictionary_open_transliterator:
+ *
+ * Returns: (transfer full): a transliterator transforming words to only base
+ * lower case characters, as typed by players
+ */
+UTransliterator *muttum_dictionary_open_transliterator (void)
+{
+  UErrorCode status = U_ZERO_ERROR;
+  UChar transliterator_id[MUTTUM_DICTIONARY_UCHAR_BUFFER_SIZE];
+
+  // Rules are compiled once by transliterator
+  u_uastrcpy(transliterator_id, "NFD; [:Nonspacing Mark:] Remove; Lower; NFC");
+  UTransliterator *transliterator = utrans_openU(
+    transliterator_id, -1,
+    UTRANS_FORWARD,
+    NULL, -1,
+    NULL,
+    &status);
+  if (U_FAILURE(status)) {
+    g_error("Unable to open unicode transliterator");
+  }
+
+  return transliterator;
+}
+
+/*
+ * muttum_dictionary_fold_word:
+ * @folded: (out caller-allocates): at least %MUTTUM_DICTIONARY_FOLDED_SIZE bytes
+ *
+ * Transforms @word with a transliterator from
+ * muttum_dictionary_open_transliterator(). Latin words are folded by the
+ * table of muttum-fold.h, ICU is only called for other characters.
+ *
+ * Returns: %FALSE if @word isn't valid UTF-8 or is too long to be folded,
+ * @folded is empty then
+ */
+gboolean muttum_dictionary_fold_word (
+    UTransliterator *transliterator,
+    const gchar *word,
+    gchar *folded)
+{
+  UErrorCode status = U_ZERO_ERROR;
+  UChar u_word[MUTTUM_DICTIONARY_UCHAR_BUFFER_SIZE];
+  int32_t u_word_limit = 0;
+
+  if (muttum_fold_word(word, folded, MUTTUM_DICTIONARY_FOLDED_SIZE)) {
+    return TRUE;
+  }
+
+  u_strFromUTF8(u_word, G_N_ELEMENTS(u_word), &u_word_limit, word, -1, &status);
+  if (U_SUCCESS(status)) {
+    utrans_transUChars(transliterator, u_word, &u_word_limit, G_N_ELEMENTS(u_word), 0, &u_word_limit, &status);
+  }
+  if (U_SUCCESS(status)) {
+    u_strToUTF8(folded, MUTTUM_DICTIONARY_FOLDED_SIZE, NULL, u_word, u_word_limit, &status);
+  }
+
+  // A folded word filling the whole buffer isn't NUL terminated
+  if (U_FAILURE(status) || status == U_STRING_NOT_TERMINATED_WARNING) {
+    folded[0] = '\0';
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/*
+ * muttum_dictionary_compute_key:
+ * @buffer: a caller allocated buffer used when the key fits inside
+ * @key_size: (out): size of the key including its trailing NUL byte
+ *
+ * Returns: (transfer full) (nullable): @buffer or a newly allocated key
+ * when it was too small, %NULL if @word isn't valid UTF-8 or is too long
+ */
+guint8 *muttum_dictionary_compute_key (
+    UCollator *collator,
+    const gchar *word,
+    guint8 *buffer,
+    gsize buffer_size,
+    gsize *key_size)
+{
+  UErrorCode status = U_ZERO_ERROR;
+  UChar u_word_buffer[MUTTUM_DICTIONARY_UCHAR_BUFFER_SIZE];
+  int32_t u_word_length = 0;
+  guint8 *key = buffer;
+
+  // Words are UTF-8 whatever the process codepage is
+  u_strFromUTF8(u_word_buffer, G_N_ELEMENTS(u_word_buffer), &u_word_length, word, -1, &status);
+  if (U_FAILURE(status)) {
+    return NULL;
+  }
+
+  int32_t expected_size = ucol_getSortKey(collator, u_word_buffer, u_word_length, buffer, buffer_size);
+
+  if ((gsize) expected_size > buffer_size) {
+    key = g_new(guint8, expected_size);
+    ucol_getSortKey(collator, u_word_buffer, u_word_length, key, expected_size);
+  }
+
+  if (key_size) {
+    *key_size = expected_size;
+  }
+
+  return key;
+}
+
+/*
+ * Reads the whole word list at once, local files are mapped.
+ *
+ * Returns: (transfer full) (nullable): the word list contents
+ */
+static GBytes *muttum_dictionary_load_source (
+    GFile *source,
+    GError **error)
+{
+  g_autofree gchar *path = g_file_get_path(source);
+
+  if (path) {
+    GMappedFile *file = g_mapped_file_new(path, FALSE, error);
+    if (!file) {
+      return NULL;
+    }
+
+    GBytes *bytes = g_mapped_file_get_bytes(file);
+    g_mapped_file_unref(file);
+    return bytes;
+  }
+
+  gchar *contents = NULL;
+  gsize size = 0;
+  if (!g_file_load_contents(source, NULL, &contents, &size, NULL, error)) {
+    return NULL;
+  }
+
+  return g_bytes_new_take(contents, size);
+}
+
+/*
+ * muttum_dictionary_playable_key:
+ * @transliterator: (inout): opened on first use when %NULL
+ * @folded: (out caller-allocates): %MUTTUM_DICTIONARY_FOLDED_SIZE bytes,
+ *   the word as the board shows it
+ *
+ * The board shows the transliterated word: only words it shows as the
+ * @length a-z letters of their fold key can be played, the others are only
+ * guesses. Both backends pick their words with this function.
+ *
+ * Returns: the fold key of @word if it can be played, otherwise
+ * %MUTTUM_FOLD_KEY_NONE
+ */
+static guint64 muttum_dictionary_playable_key (
+    UTransliterator **transliterator,
+    const gchar *word,
+    guint length,
+    gchar *folded)
+{
+  if (!muttum_fold_word(word, folded, MUTTUM_DICTIONARY_FOLDED_SIZE)) {
+    if (!*transliterator) {
+      *transliterator = muttum_dictionary_open_transliterator();
+    }
+    if (!muttum_dictionary_fold_word(*transliterator, word, folded)) {
+      return MUTTUM_FOLD_KEY_NONE;
+    }
+  }
+
+  guint64 fold_key = muttum_fold_key(word);
+  if (fold_key == MUTTUM_FOLD_KEY_UNKNOWN) {
+    fold_key = muttum_fold_key(folded);
+  }
+  if (fold_key == MUTTUM_FOLD_KEY_NONE || fold_key == MUTTUM_FOLD_KEY_UNKNOWN) {
+    return MUTTUM_FOLD_KEY_NONE;
+  }
+
+  gsize n_letters = strlen(folded);
+  if (n_letters != length || muttum_fold_pack(folded, n_letters) != fold_key) {
+    return MUTTUM_FOLD_KEY_NONE;
+  }
+
+  return fold_key;
+}
+
+/*
+ * Playable word of the index while its buckets are built.
+ */
+typedef struct {
+  guint64 fold_key;
+  guint32 length;
+  guint32 position;
+} MuttumDictionaryPlayable;
+
+static gint muttum_dictionary_playable_compare (
+    gconstpointer a,
+    gconstpointer b)
+{
+  const MuttumDictionaryPlayable *first = a;
+  const MuttumDictionaryPlayable *second = b;
+
+  if (first->length != second->length) {
+    return (first->length > second->length) - (first->length < second->length);
+  }
+  if (first->fold_key != second->fold_key) {
+    return (first->fold_key > second->fold_key) - (first->fold_key < second->fold_key);
+  }
+  return (first->position > second->position) - (first->position < second->position);
+}
+
+/*
+ * Lines of the word list indexed by one worker, entries refer to the keys
+ * and words of their own chunk until they are merged.
+ */
+typedef struct {
+  const gchar *start;
+  const gchar *end;
+  GArray *entries;
+  GByteArray *keys;
+  GByteArray *words;
+  GArray *folded;
+} MuttumDictionaryChunk;
+
+typedef struct {
+  // Cloned by each chunk, a collator can't be used by several threads
+  UCollator *collator;
+  UTransliterator *transliterator;
+  guint word_length_min;
+  guint word_length_max;
+} MuttumDictionaryChunkBuild;
+
+static void muttum_dictionary_chunk_add (
+    MuttumDictionaryChunk *chunk,
+    UCollator *collator,
+    guint64 fold_key,
+    const gchar *word,
+    glong length)
+{
+  guint8 key_buffer[MUTTUM_DICTIONARY_UCHAR_BUFFER_SIZE];
+  gsize key_size = 0;
+  guint8 *key = muttum_dictionary_compute_key(collator, word,
+      key_buffer, sizeof(key_buffer), &key_size);
+  if (!key) {
+    return;
+  }
+
+  MuttumDictionaryIndexEntry entry = { 0 };
+  entry.key = chunk->keys->len;
+  entry.word = chunk->words->len;
+  entry.length = length;
+  entry.is_playable = TRUE;
+
+  g_byte_array_append(chunk->keys, key, key_size);
+  g_byte_array_append(chunk->words, (const guint8 *) word, strlen(word) + 1);
+  g_array_append_val(chunk->entries, entry);
+
+  if (fold_key != MUTTUM_FOLD_KEY_NONE) {
+    g_array_append_val(chunk->folded, fold_key);
+  }
+
+  if (key != key_buffer) {
+    g_free(key);
+  }
+}
+
+/*
+ * Returns: the fold key of @word, words out of the fold table are first
+ * transliterated by ICU
+ */
+static guint64 muttum_dictionary_chunk_fold_key (
+    const MuttumDictionaryChunkBuild *build,
+    UTransliterator **transliterator,
+    const gchar *word)
+{
+  guint64 fold_key = muttum_fold_key(word);
+  if (fold_key != MUTTUM_FOLD_KEY_UNKNOWN) {
+    return fold_key;
+  }
+
+  // Cloned on first use, most word lists never need it
+  if (!*transliterator) {
+    UErrorCode status = U_ZERO_ERROR;
+    *transliterator = utrans_clone(build->transliterator, &status);
+    if (U_FAILURE(status)) {
+      g_error("Unable to clone unicode transliterator");
+    }
+  }
+
+  gchar folded[MUTTUM_DICTIONARY_FOLDED_SIZE];
+  if (!muttum_dictionary_fold_word(*transliterator, word, folded)) {
+    return MUTTUM_FOLD_KEY_NONE;
+  }
+  fold_key = muttum_fold_key(folded);
+
+  return fold_key == MUTTUM_FOLD_KEY_UNKNOWN ? MUTTUM_FOLD_KEY_NONE : fold_key;
+}
+
+/*
+ * Runs in a worker thread: converts each line of the chunk from UTF-8 and
+ * computes its collation and fold keys.
+ */
+static void muttum_dictionary_chunk_run (
+    gpointer data,
+    gpointer user_data)
+{
+  MuttumDictionaryChunk *chunk = data;
+  const MuttumDictionaryChunkBuild *build = user_data;
+  UErrorCode status = U_ZERO_ERROR;
+
+#if U_ICU_VERSION_MAJOR_NUM >= 71
+  UCollator *collator = ucol_clone(build->collator, &status);
+#else
+  UCollator *collator = ucol_safeClone(build->collator, NULL, NULL, &status);
+#endif
+  if (U_FAILURE(status)) {
+    g_error("Unable to clone unicode collator");
+  }
+  UTransliterator *transliterator = NULL;
+
+  const gchar *line = chunk->start;
+  while (line < chunk->end) {
+    const gchar *line_end = memchr(line, '\n', chunk->end - line);
+    if (!line_end) {
+      // Last line may not be terminated by a new line
+      line_end = chunk->end;
+    }
+    gsize size = line_end - line;
+
+    // Longer lines can't be words of the length range, even with 4 bytes
+    // by character
+    gchar word[MUTTUM_DICTIONARY_FOLDED_SIZE];
+    if (size < sizeof(word) && g_utf8_validate_len(line, size, NULL)) {
+      memcpy(word, line, size);
+      word[size] = '\0';
+
+      glong length = g_utf8_strlen(word, size);
+      if (length >= (glong) build->word_length_min && length <= (glong) build->word_length_max) {
+        guint64 fold_key = muttum_dictionary_chunk_fold_key(build, &transliterator, word);
+        muttum_dictionary_chunk_add(chunk, collator, fold_key, word, length);
+      }
+    }
+
+    line = line_end + 1;
+  }
+
+  ucol_close(collator);
+  if (transliterator) {
+    utrans_close(transliterator);
+  }
+}
+
+/*
+ * Splits @contents in about @n_chunks chunks of whole lines.
+ */
+static MuttumDictionaryChunk *muttum_dictionary_chunks_new (
+    GBytes *contents,
+    guint n_chunks)
+{
+  gsize size = 0;
+  const gchar *data = g_bytes_get_data(contents, &size);
+  const gchar *data_end = data + size;
+  MuttumDictionaryChunk *chunks = g_new0(MuttumDictionaryChunk, n_chunks);
+  const gchar *start = data;
+
+  for (guint i = 0; i < n_chunks; i += 1) {
+    const gchar *end = data_end;
+
+    // Chunk ends after the first new line past its share of the contents
+    if (i + 1 < n_chunks) {
+      const gchar *boundary = MAX(start, data + size / n_chunks * (i + 1));
+      end = memchr(boundary, '\n', data_end - boundary);
+      end = end ? end + 1 : data_end;
+    }
+
+    chunks[i].start = start;
+    chunks[i].end = end;
+    chunks[i].entries = g_array_new(FALSE, FALSE, sizeof(MuttumDictionaryIndexEntry));
+    chunks[i].keys = g_byte_array_new();
+    chunks[i].words = g_byte_array_new();
+    chunks[i].folded = g_array_new(FALSE, FALSE, sizeof(guint64));
+    start = end;
+  }
+
+  return chunks;
+}
+
+static void muttum_dictionary_chunks_free (
+    MuttumDictionaryChunk *chunks,
+    guint n_chunks)
+{
+  for (guint i = 0; i < n_chunks; i += 1) {
+    g_clear_pointer(&chunks[i].entries, g_array_unref);
+    g_clear_pointer(&chunks[i].keys, g_byte_array_unref);
+    g_clear_pointer(&chunks[i].words, g_byte_array_unref);
+    g_clear_pointer(&chunks[i].folded, g_array_unref);
+  }
+  g_free(chunks);
+}
+
+static gint muttum_dictionary_index_builder_compare (
+    gconstpointer a,
+    gconstpointer b,
+    gpointer user_data)
+{
+  const gchar *keys = user_data;
+  const MuttumDictionaryIndexEntry *first = a;
+  const MuttumDictionaryIndexEntry *second = b;
+  gint result = strcmp(keys + first->key, keys + second->key);
+
+  // Keep words collapsed on the same key in their word list order
+  if (result == 0) {
+    result = (first->word > second->word) - (first->word < second->word);
+  }
+  return result;
+}
+
+static gint muttum_dictionary_index_fold_key_compare (
+    gconstpointer a,
+    gconstpointer b)
+{
+  guint64 first = *(const guint64 *) a;
+  guint64 second = *(const guint64 *) b;
+  return (first > second) - (first < second);
+}
+
+static void muttum_dictionary_index_align (GByteArray *data)
+{
+  static const guint8 padding[8] = { 0 };
+  g_byte_array_append(data, padding, (8 - data->len % 8) % 8);
+}
+
+/*
+ * muttum_dictionary_index_build:
+ * @source: the word list to index
+ *
+ * Builds the binary index of @source: collation keys are sorted, words
+ * collapsing on the same key keep only their first spelling.
+ *
+ * Returns: (transfer full) (nullable): the index contents or %NULL if the word list couldn't be read
+ */
+static GBytes *muttum_dictionary_index_build (
+    GFile *source,
+    const gchar *locale,
+    guint word_length_min,
+    guint word_length_max,
+    GError **error)
+{
+  g_return_val_if_fail(strlen(locale) < MUTTUM_DICTIONARY_LOCALE_SIZE, NULL);
+  g_return_val_if_fail(word_length_max * 4 < MUTTUM_DICTIONARY_FOLDED_SIZE, NULL);
+
+  g_autoptr(GFileInfo) info = g_file_query_info(source,
+      MUTTUM_DICTIONARY_SOURCE_ATTRIBUTES, G_FILE_QUERY_INFO_NONE, NULL, error);
+  if (!info) {
+    return NULL;
+  }
+
+  g_autoptr(GBytes) source_contents = muttum_dictionary_load_source(source, error);
+  if (!source_contents) {
+    return NULL;
+  }
+
+  // Lines are converted and keyed in parallel, chunks are merged in word
+  // list order
+  MuttumDictionaryChunkBuild build = {
+    .collator = muttum_dictionary_open_collator(locale),
+    .transliterator = muttum_dictionary_open_transliterator(),
+    .word_length_min = word_length_min,
+    .word_length_max = word_length_max,
+  };
+  guint n_chunks = MAX(1, MIN(g_get_num_processors() * MUTTUM_DICTIONARY_CHUNKS_BY_THREAD,
+      g_bytes_get_size(source_contents) / MUTTUM_DICTIONARY_CHUNK_SIZE_MIN));
+  MuttumDictionaryChunk *chunks = muttum_dictionary_chunks_new(source_contents, n_chunks);
+
+  GThreadPool *pool = g_thread_pool_new(muttum_dictionary_chunk_run, &build,
+      g_get_num_processors(), TRUE, error);
+  if (!pool) {
+    muttum_dictionary_chunks_free(chunks, n_chunks);
+    ucol_close(build.collator);
+    utrans_close(build.transliterator);
+    return NULL;
+  }
+
+  for (guint i = 0; i < n_chunks; i += 1) {
+    g_thread_pool_push(pool, &chunks[i], NULL);
+  }
+
+  // Waits for every chunk
+  g_thread_pool_free(pool, FALSE, TRUE);
+
+  gsize n_entries = 0;
+  gsize keys_size = 0;
+  gsize words_size = 0;
+  gsize n_folded = 0;
+  for (guint i = 0; i < n_chunks; i += 1) {
+    n_entries += chunks[i].entries->len;
+    keys_size += chunks[i].keys->len;
+    words_size += chunks[i].words->len;
+    n_folded += chunks[i].folded->len;
+  }
+
+  GArray *all_entries = g_array_sized_new(FALSE, FALSE, sizeof(MuttumDictionaryIndexEntry), n_entries);
+  GByteArray *all_keys = g_byte_array_sized_new(keys_size);
+  GByteArray *all_words = g_byte_array_sized_new(words_size);
+  GArray *folded = g_array_sized_new(FALSE, FALSE, sizeof(guint64), n_folded);
+  for (guint i = 0; i < n_chunks; i += 1) {
+    for (guint j = 0; j < chunks[i].entries->len; j += 1) {
+      MuttumDictionaryIndexEntry entry = g_array_index(chunks[i].entries, MuttumDictionaryIndexEntry, j);
+      entry.key += all_keys->len;
+      entry.word += all_words->len;
+      g_array_append_val(all_entries, entry);
+    }
+    g_byte_array_append(all_keys, chunks[i].keys->data, chunks[i].keys->len);
+    g_byte_array_append(all_words, chunks[i].words->data, chunks[i].words->len);
+    g_array_append_vals(folded, chunks[i].folded->data, chunks[i].folded->len);
+
+    // Only one chunk is held twice at a time
+    g_clear_pointer(&chunks[i].entries, g_array_unref);
+    g_clear_pointer(&chunks[i].keys, g_byte_array_unref);
+    g_clear_pointer(&chunks[i].words, g_byte_array_unref);
+    g_clear_pointer(&chunks[i].folded, g_array_unref);
+  }
+  muttum_dictionary_chunks_free(chunks, n_chunks);
+
+  // Fold keys are deduplicated in place once sorted
+  g_array_sort(folded, muttum_dictionary_index_fold_key_compare);
+  n_folded = 0;
+  for (guint i = 0; i < folded->len; i += 1) {
+    guint64 fold_key = g_array_index(folded, guint64, i);
+    if (n_folded == 0 || g_array_index(folded, guint64, n_folded - 1) != fold_key) {
+      g_array_index(folded, guint64, n_folded++) = fold_key;
+    }
+  }
+  g_array_set_size(folded, n_folded);
+
+  g_array_sort_with_data(all_entries,
+      muttum_dictionary_index_builder_compare, all_keys->data);
+
+  // Keys and words are rewritten in sorted order without collapsed
+  // duplicates, so a lookup only touches neighbour pages. Their offsets
+  // are computed first, they are copied straight into the index.
+  GArray *entries = g_array_sized_new(FALSE, FALSE, sizeof(MuttumDictionaryIndexEntry), all_entries->len);
+  GArray *sources = g_array_sized_new(FALSE, FALSE, sizeof(MuttumDictionaryIndexEntry), all_entries->len);
+  const gchar *previous_key = NULL;
+  guint n_collapsed = 0;
+  keys_size = 0;
+  words_size = 0;
+
+  for (guint i = 0; i < all_entries->len; i += 1) {
+    MuttumDictionaryIndexEntry entry = g_array_index(all_entries, MuttumDictionaryIndexEntry, i);
+    const gchar *key = (const gchar *) all_keys->data + entry.key;
+    const gchar *word = (const gchar *) all_words->data + entry.word;
+
+    if (previous_key && strcmp(previous_key, key) == 0) {
+      n_collapsed += 1;
+      continue;
+    }
+    previous_key = key;
+    g_array_append_val(sources, entry);
+
+    entry.key = keys_size;
+    entry.word = words_size;
+    keys_size += strlen(key) + 1;
+    words_size += strlen(word) + 1;
+    g_array_append_val(entries, entry);
+  }
+  g_array_unref(all_entries);
+
+  // Playable words by length: bucket boundaries followed by entry positions
+  // sorted by fold key, the rank order of the automaton backend. Words of
+  // the same letters are played by their first spelling only.
+  guint n_lengths = word_length_max - word_length_min + 1;
+  guint32 *buckets = g_new0(guint32, n_lengths + 1 + entries->len);
+  guint32 *positions = buckets + n_lengths + 1;
+  GArray *playable = g_array_sized_new(FALSE, FALSE, sizeof(MuttumDictionaryPlayable), entries->len);
+  for (guint i = 0; i < entries->len; i += 1) {
+    MuttumDictionaryIndexEntry *entry = &g_array_index(entries, MuttumDictionaryIndexEntry, i);
+    const gchar *word = (const gchar *) all_words->data + g_array_index(sources, MuttumDictionaryIndexEntry, i).word;
+    gchar folded[MUTTUM_DICTIONARY_FOLDED_SIZE];
+    MuttumDictionaryPlayable word_playable = { 0 };
+
+    word_playable.fold_key = muttum_dictionary_playable_key(&build.transliterator, word, entry->length, folded);
+    word_playable.length = entry->length;
+    word_playable.position = i;
+    entry->is_playable = word_playable.fold_key != MUTTUM_FOLD_KEY_NONE;
+    if (entry->is_playable) {
+      g_array_append_val(playable, word_playable);
+    }
+  }
+  g_array_sort(playable, muttum_dictionary_playable_compare);
+
+  guint n_playable = 0;
+  for (guint i = 0; i < playable->len; i += 1) {
+    const MuttumDictionaryPlayable *word_playable = &g_array_index(playable, MuttumDictionaryPlayable, i);
+    if (i > 0 && (word_playable - 1)->length == word_playable->length
+        && (word_playable - 1)->fold_key == word_playable->fold_key) {
+      g_array_index(entries, MuttumDictionaryIndexEntry, word_playable->position).is_playable = FALSE;
+      continue;
+    }
+    buckets[word_playable->length - word_length_min + 1] += 1;
+    positions[n_playable++] = word_playable->position;
+  }
+  g_array_unref(playable);
+  for (guint length = 1; length <= n_lengths; length += 1) {
+    buckets[length] += buckets[length - 1];
+  }
+  gsize buckets_size = (n_lengths + 1 + buckets[n_lengths]) * sizeof(guint32);
+
+  MuttumDictionaryIndexHeader header = { 0 };
+  memcpy(header.magic, MUTTUM_DICTIONARY_INDEX_MAGIC, sizeof(header.magic));
+  header.version = MUTTUM_DICTIONARY_INDEX_VERSION;
+  header.n_words = entries->len;
+  g_strlcpy(header.locale, locale, sizeof(header.locale));
+  ucol_getVersion(build.collator, header.collator_version);
+  header.word_length_min = word_length_min;
+  header.word_length_max = word_length_max;
+  header.n_collapsed = n_collapsed;
+  header.source_size = g_file_info_get_size(info);
+  header.source_mtime = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+
+  // Reserve the whole index at once, it's built in a single allocation
+  gsize data_size = sizeof(header) + entries->len * sizeof(MuttumDictionaryIndexEntry)
+    + buckets_size + keys_size + words_size + folded->len * sizeof(guint64) + 5 * 8;
+  GByteArray *data = g_byte_array_sized_new(data_size);
+  g_byte_array_append(data, (const guint8 *) &header, sizeof(header));
+  muttum_dictionary_index_align(data);
+
+  header.entries_offset = data->len;
+  g_byte_array_append(data, (const guint8 *) entries->data, entries->len * sizeof(MuttumDictionaryIndexEntry));
+  muttum_dictionary_index_align(data);
+
+  header.buckets_offset = data->len;
+  header.buckets_size = buckets_size;
+  g_byte_array_append(data, (const guint8 *) buckets, buckets_size);
+  muttum_dictionary_index_align(data);
+
+  header.keys_offset = data->len;
+  header.keys_size = keys_size;
+  for (guint i = 0; i < sources->len; i += 1) {
+    const gchar *key = (const gchar *) all_keys->data + g_array_index(sources, MuttumDictionaryIndexEntry, i).key;
+    g_byte_array_append(data, (const guint8 *) key, strlen(key) + 1);
+  }
+  muttum_dictionary_index_align(data);
+
+  header.words_offset = data->len;
+  header.words_size = words_size;
+  for (guint i = 0; i < sources->len; i += 1) {
+    const gchar *word = (const gchar *) all_words->data + g_array_index(sources, MuttumDictionaryIndexEntry, i).word;
+    g_byte_array_append(data, (const guint8 *) word, strlen(word) + 1);
+  }
+  muttum_dictionary_index_align(data);
+
+  header.folded_offset = data->len;
+  header.n_folded = folded->len;
+  g_byte_array_append(data, (const guint8 *) folded->data, folded->len * sizeof(guint64));
+
+  // Header is complete only once all sections are placed
+  memcpy(data->data, &header, sizeof(header));
+
+  GBytes *contents = g_byte_array_free_to_bytes(data);
+
+  g_free(buckets);
+  g_array_unref(sources);
+  g_array_unref(entries);
+  g_array_unref(folded);
+  g_byte_array_unref(all_words);
+  g_byte_array_unref(all_keys);
+  ucol_close(build.collator);
+  utrans_close(build.transliterator);
+
+  return contents;
+}
+
+/*
+ * muttum_dictionary_index_write:
+ * @source: the word list to index
+ * @output_path: where the binary index is written
+ *
+ * Returns: %FALSE if the word list couldn't be read or the index written
+ */
+gboolean muttum_dictionary_index_write (
+    GFile *source,
+    const gchar *locale,
+    guint word_length_min,
+    guint word_length_max,
+    const gchar *output_path,
+    GError **error)
+{
+  g_autoptr(GBytes) contents = muttum_dictionary_index_build(source, locale,
+      word_length_min, word_length_max, error);
+  if (!contents) {
+    return FALSE;
+  }
+
+  gsize size = 0;
+  const gchar *data = g_bytes_get_data(contents, &size);
+  return g_file_set_contents(output_path, data, size, error);
+}
+
+static gboolean muttum_dictionary_index_section_is_valid (
+    gsize file_size,
+    guint64 offset,
+    guint64 size)
+{
+  return offset <= file_size && size <= file_size - offset;
+}
+
+static gboolean muttum_dictionary_index_buckets_are_valid (
+    const gchar *contents,
+    const MuttumDictionaryIndexHeader *header)
+{
+  if (header->word_length_min > header->word_length_max
+      || header->buckets_offset % 8 != 0) {
+    return FALSE;
+  }
+
+  guint n_lengths = header->word_length_max - header->word_length_min + 1;
+  const guint32 *buckets = (const guint32 *) (contents + header->buckets_offset);
+
+  if (header->buckets_size < (n_lengths + 1) * sizeof(guint32) || buckets[0] != 0) {
+    return FALSE;
+  }
+
+  for (guint length = 1; length <= n_lengths; length += 1) {
+    if (buckets[length] < buckets[length - 1]) {
+      return FALSE;
+    }
+  }
+
+  return buckets[n_lengths] <= header->n_words
+    && header->buckets_size == (n_lengths + 1 + buckets[n_lengths]) * sizeof(guint32);
+}
+
+/*
+ * Checks every offset of the entries against its arena and every bucket
+ * position against the entries, once the sections are known to fit in the
+ * file: a truncated or stale index is rejected instead of read out of
+ * bounds.
+ */
+static gboolean muttum_dictionary_index_entries_are_valid (
+    const gchar *contents,
+    const MuttumDictionaryIndexHeader *header)
+{
+  const MuttumDictionaryIndexEntry *entries = (const MuttumDictionaryIndexEntry *) (contents + header->entries_offset);
+  const guint32 *buckets = (const guint32 *) (contents + header->buckets_offset);
+  guint n_lengths = header->word_length_max - header->word_length_min + 1;
+  const guint32 *positions = buckets + n_lengths + 1;
+
+  for (guint i = 0; i < header->n_words; i += 1) {
+    const MuttumDictionaryIndexEntry *entry = &entries[i];
+    if (entry->key >= header->keys_size
+        || entry->word >= header->words_size
+        || entry->is_playable > 1
+        || (entry->is_playable
+          && (entry->length < header->word_length_min || entry->length > header->word_length_max))) {
+      return FALSE;
+    }
+  }
+
+  for (guint length = 0; length < n_lengths; length += 1) {
+    for (guint32 i = buckets[length]; i < buckets[length + 1]; i += 1) {
+      if (positions[i] >= header->n_words
+          || !entries[positions[i]].is_playable
+          || entries[positions[i]].length != header->word_length_min + length) {
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+static MuttumDictionaryIndex *muttum_dictionary_index_new_from_bytes (GBytes *bytes)
+{
+  const gchar *contents = g_bytes_get_data(bytes, NULL);
+  const MuttumDictionaryIndexHeader *header = (const MuttumDictionaryIndexHeader *) contents;
+
+  MuttumDictionaryIndex *index = g_new(MuttumDictionaryIndex, 1);
+  index->bytes = bytes;
+  index->header = header;
+  index->entries = (const MuttumDictionaryIndexEntry *) (contents + header->entries_offset);
+  index->buckets = (const guint32 *) (contents + header->buckets_offset);
+  index->positions = index->buckets + header->word_length_max - header->word_length_min + 2;
+  index->keys = contents + header->keys_offset;
+  index->words = contents + header->words_offset;
+  index->folded = (const guint64 *) (contents + header->folded_offset);
+
+  return index;
+}
+
+/*
+ * muttum_dictionary_index_new:
+ * @source: the word list to index
+ *
+ * Builds the index in memory, used when no valid index file is available.
+ *
+ * Returns: (transfer full) (nullable): the index or %NULL if the word list couldn't be read
+ */
+MuttumDictionaryIndex *muttum_dictionary_index_new (
+    GFile *source,
+    const gchar *locale,
+    guint word_length_min,
+    guint word_length_max,
+    GError **error)
+{
+  GBytes *contents = muttum_dictionary_index_build(source, locale,
+      word_length_min, word_length_max, error);
+  if (!contents) {
+    return NULL;
+  }
+
+  return muttum_dictionary_index_new_from_bytes(contents);
+}
+
+/*
+ * muttum_dictionary_index_open:
+ * @path: the binary index built by muttum-dictionary-compile
+ * @source: the word list the index must have been built from
+ *
+ * Maps the index in memory. The index is rejected when it was built with
+ * other parameters, another collator version or when @source changed since.
+ *
+ * Returns: (transfer full) (nullable): the mapped index or %NULL when it's missing or stale
+ */
+MuttumDictionaryIndex *muttum_dictionary_index_open (
+    const gchar *path,
+    GFile *source,
+    UCollator *collator,
+    const gchar *locale,
+    guint word_length_min,
+    guint word_length_max,
+    GError **error)
+{
+  GMappedFile *file = g_mapped_file_new(path, FALSE, error);
+  if (!file) {
+    return NULL;
+  }
+
+  // Bytes keep a reference on the mapping
+  g_autoptr(GBytes) bytes = g_mapped_file_get_bytes(file);
+  g_mapped_file_unref(file);
+
+  gsize file_size = 0;
+  const gchar *contents = g_bytes_get_data(bytes, &file_size);
+  const MuttumDictionaryIndexHeader *header = (const MuttumDictionaryIndexHeader *) contents;
+
+  if (file_size < sizeof(MuttumDictionaryIndexHeader)
+      || memcmp(header->magic, MUTTUM_DICTIONARY_INDEX_MAGIC, sizeof(header->magic)) != 0
+      || header->version != MUTTUM_DICTIONARY_INDEX_VERSION
+      || header->entries_offset % 8 != 0
+      || !muttum_dictionary_index_section_is_valid(file_size, header->entries_offset,
+        (guint64) header->n_words * sizeof(MuttumDictionaryIndexEntry))
+      || !muttum_dictionary_index_section_is_valid(file_size, header->buckets_offset, header->buckets_size)
+      || !muttum_dictionary_index_buckets_are_valid(contents, header)
+      || !muttum_dictionary_index_section_is_valid(file_size, header->keys_offset, header->keys_size)
+      || !muttum_dictionary_index_section_is_valid(file_size, header->words_offset, header->words_size)
+      || header->folded_offset % 8 != 0
+      || header->n_folded > file_size / sizeof(guint64)
+      || !muttum_dictionary_index_section_is_valid(file_size, header->folded_offset,
+        header->n_folded * sizeof(guint64))
+      || (header->keys_size > 0 && contents[header->keys_offset + header->keys_size - 1] != '\0')
+      || (header->words_size > 0 && contents[header->words_offset + header->words_size - 1] != '\0')
+      || !muttum_dictionary_index_entries_are_valid(contents, header)) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+        "Dictionary index %s is corrupted or has an unknown version", path);
+    return NULL;
+  }
+
+  UVersionInfo collator_version;
+  ucol_getVersion(collator, collator_version);
+
+  g_autoptr(GFileInfo) info = g_file_query_info(source,
+      MUTTUM_DICTIONARY_SOURCE_ATTRIBUTES, G_FILE_QUERY_INFO_NONE, NULL, error);
+  if (!info) {
+    return NULL;
+  }
+
+  if (strncmp(header->locale, locale, sizeof(header->locale)) != 0
+      || memcmp(header->collator_version, collator_version, sizeof(collator_version)) != 0
+      || header->word_length_min != word_length_min
+      || header->word_length_max != word_length_max
+      || header->source_size != (guint64) g_file_info_get_size(info)
+      || header->source_mtime != g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED)) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+        "Dictionary index %s is stale", path);
+    return NULL;
+  }
+
+  return muttum_dictionary_index_new_from_bytes(g_steal_pointer(&bytes));
+}
+
+void muttum_dictionary_index_free (MuttumDictionaryIndex *index)
+{
+  if (!index) {
+    return;
+  }
+
+  g_bytes_unref(index->bytes);
+  g_free(index);
+}
+
+guint muttum_dictionary_index_get_n_words (MuttumDictionaryIndex *index)
+{
+  return index->header->n_words;
+}
+
+const MuttumDictionaryIndexEntry *muttum_dictionary_index_get_entry (
+    MuttumDictionaryIndex *index,
+    guint position)
+{
+  g_return_val_if_fail(position < index->header->n_words, NULL);
+  return &index->entries[position];
+}
+
+/*
+ * muttum_dictionary_index_get_n_playable:
+ *
+ * Returns: the number of playable words of @length characters
+ */
+guint muttum_dictionary_index_get_n_playable (
+    MuttumDictionaryIndex *index,
+    guint length)
+{
+  if (length < index->header->word_length_min || length > index->header->word_length_max) {
+    return 0;
+  }
+
+  guint bucket = length - index->header->word_length_min;
+  return index->buckets[bucket + 1] - index->buckets[bucket];
+}
+
+/*
+ * muttum_dictionary_index_get_playable:
+ * @position: position of the word inside the @length bucket
+ *
+ * Returns: (transfer none): the entry of the playable word
+ */
+const MuttumDictionaryIndexEntry *muttum_dictionary_index_get_playable (
+    MuttumDictionaryIndex *index,
+    guint length,
+    guint position)
+{
+  g_return_val_if_fail(position < muttum_dictionary_index_get_n_playable(index, length), NULL);
+
+  guint bucket = length - index->header->word_length_min;
+  return &index->entries[index->positions[index->buckets[bucket] + position]];
+}
+
+const gchar *muttum_dictionary_index_get_word (
+    MuttumDictionaryIndex *index,
+    const MuttumDictionaryIndexEntry *entry)
+{
+  return index->words + entry->word;
+}
+
+/*
+ * muttum_dictionary_index_lookup:
+ * @key: a NUL terminated collation key
+ *
+ * Branch-free binary search done straight on the index pages: the only
+ * branch depending on the key is the final equality test, the halving
+ * step compiles to a conditional move. Nothing is allocated.
+ *
+ * Returns: (transfer none) (nullable): the entry of @key
+ */
+const MuttumDictionaryIndexEntry *muttum_dictionary_index_lookup (
+    MuttumDictionaryIndex *index,
+    const guint8 *key)
+{
+  const MuttumDictionaryIndexEntry *base = index->entries;
+  guint n_words = index->header->n_words;
+
+  if (n_words == 0) {
+    return NULL;
+  }
+
+  // Invariant: the last entry lower or equal to key is in [base, base + n_words)
+  while (n_words > 1) {
+    guint half = n_words / 2;
+    base = strcmp(index->keys + base[half].key, (const gchar *) key) <= 0 ? base + half : base;
+    n_words -= half;
+  }
+
+  return strcmp(index->keys + base->key, (const gchar *) key) == 0 ? base : NULL;
+}
+
+/*
+ * muttum_dictionary_index_get_size:
+ *
+ * Returns: number of bytes of the index, mapped or allocated
+ */
+gsize muttum_dictionary_index_get_size (MuttumDictionaryIndex *index)
+{
+  return g_bytes_get_size(index->bytes);
+}
+
+/*
+ * muttum_dictionary_backend_from_string:
+ * @name: (nullable): "index" or "automaton"
+ *
+ * Returns: the named backend, the index backend by default
+ */
+MuttumDictionaryBackend muttum_dictionary_backend_from_string (const gchar *name)
+{
+  if (g_strcmp0(name, "automaton") == 0) {
+    return MUTTUM_DICTIONARY_BACKEND_AUTOMATON;
+  }
+
+  if (name && g_strcmp0(name, "index") != 0) {
+    g_warning("Unknown dictionary backend %s, using index", name);
+  }
+
+  return MUTTUM_DICTIONARY_BACKEND_INDEX;
+}
+
+/*
+ * Word of the index keyed by its letters while the automaton is built.
+ */
+typedef struct {
+  guint64 fold_key;
+  guint32 word;
+  guint32 n_letters;
+  gboolean is_spelled_as_folded;
+} MuttumDictionaryFoldedWord;
+
+static gint muttum_dictionary_folded_word_compare (
+    gconstpointer a,
+    gconstpointer b)
+{
+  const MuttumDictionaryFoldedWord *first = a;
+  const MuttumDictionaryFoldedWord *second = b;
+
+  if (first->n_letters != second->n_letters) {
+    return (first->n_letters > second->n_letters) - (first->n_letters < second->n_letters);
+  }
+  return (first->fold_key > second->fold_key) - (first->fold_key < second->fold_key);
+}
+
+static void muttum_dictionary_build_automaton (
+    MuttumDictionary *dictionary,
+    MuttumDictionaryIndex *index)
+{
+  const MuttumDictionaryIndexHeader *header = index->header;
+  GArray *folded_words = g_array_new(FALSE, FALSE, sizeof(MuttumDictionaryFoldedWord));
+  GArray *playable_keys = g_array_new(FALSE, FALSE, sizeof(guint64));
+  UTransliterator *transliterator = NULL;
+  guint8 symbols[1 + MUTTUM_FOLD_LENGTH_MAX];
+
+  // Words are keyed by the letters of their fold key, as the folded section
+  // of the index. The index buckets hold the playable words, with the
+  // letters of each word in rank order already.
+  for (guint length = header->word_length_min; length <= header->word_length_max; length += 1) {
+    guint n_words = muttum_dictionary_index_get_n_playable(index, length);
+    for (guint position = 0; position < n_words; position += 1) {
+      const MuttumDictionaryIndexEntry *entry = muttum_dictionary_index_get_playable(index, length, position);
+      const gchar *word = index->words + entry->word;
+      gchar folded[MUTTUM_DICTIONARY_FOLDED_SIZE];
+
+      guint64 fold_key = muttum_dictionary_playable_key(&transliterator, word, length, folded);
+      if (fold_key == MUTTUM_FOLD_KEY_NONE) {
+        continue;
+      }
+
+      MuttumDictionaryFoldedWord folded_word = { 0 };
+      folded_word.fold_key = fold_key;
+      folded_word.word = entry->word;
+      folded_word.n_letters = length;
+      folded_word.is_spelled_as_folded = strcmp(word, folded) == 0;
+      g_array_append_val(folded_words, folded_word);
+      g_array_append_val(playable_keys, fold_key);
+    }
+  }
+
+  if (transliterator) {
+    utrans_close(transliterator);
+  }
+
+  // Sorted by the index already, a stale index can't break the automaton
+  // builder
+  g_array_sort(folded_words, muttum_dictionary_folded_word_compare);
+  g_array_sort(playable_keys, muttum_dictionary_index_fold_key_compare);
+
+  // Other words of the index are only guesses
+  GArray *guess_keys = g_array_new(FALSE, FALSE, sizeof(guint64));
+  guint n_playable_keys = 0;
+  for (guint64 i = 0; i < header->n_folded; i += 1) {
+    guint64 fold_key = index->folded[i];
+    while (n_playable_keys < playable_keys->len && g_array_index(playable_keys, guint64, n_playable_keys) < fold_key) {
+      n_playable_keys += 1;
+    }
+    if (n_playable_keys == playable_keys->len || g_array_index(playable_keys, guint64, n_playable_keys) != fold_key) {
+      g_array_append_val(guess_keys, fold_key);
+    }
+  }
+  g_array_unref(playable_keys);
+
+  MuttumAutomatonBuilder *builder = muttum_automaton_builder_new();
+  GArray *spellings = g_array_new(FALSE, FALSE, sizeof(MuttumDictionarySpelling));
+  GByteArray *spelling_words = g_byte_array_new();
+  guint rank = 0;
+
+  for (guint i = 0; i < folded_words->len; i += 1) {
+    const MuttumDictionaryFoldedWord *folded_word = &g_array_index(folded_words, MuttumDictionaryFoldedWord, i);
+
+    if (i > 0 && (folded_word - 1)->fold_key == folded_word->fold_key) {
+      continue;
+    }
+
+    symbols[0] = folded_word->n_letters;
+    muttum_fold_unpack(folded_word->fold_key, symbols + 1);
+    muttum_automaton_builder_add(builder, symbols, folded_word->n_letters + 1);
+
+    if (!folded_word->is_spelled_as_folded) {
+      const gchar *word = index->words + folded_word->word;
+      MuttumDictionarySpelling spelling = { rank, spelling_words->len };
+      g_array_append_val(spellings, spelling);
+      g_byte_array_append(spelling_words, (const guint8 *) word, strlen(word) + 1);
+    }
+    rank += 1;
+  }
+
+  dictionary->automaton = muttum_automaton_builder_finish(builder);
+  dictionary->n_guess_keys = guess_keys->len;
+  dictionary->guess_keys = (guint64 *) g_array_free(guess_keys, FALSE);
+  dictionary->n_spellings = spellings->len;
+  dictionary->spellings = (MuttumDictionarySpelling *) g_array_free(spellings, FALSE);
+  dictionary->spelling_words_size = spelling_words->len;
+  dictionary->spelling_words = (gchar *) g_byte_array_free(spelling_words, FALSE);
+  dictionary->n_collapsed = header->n_collapsed;
+
+  g_array_unref(folded_words);
+}
+
+/*
+ * muttum_dictionary_new:
+ * @index: (transfer full): the dictionary index
+ *
+ * With the automaton backend, @index is only used to build the automaton
+ * and released afterwards. The automaton keeps the playable words of the
+ * index, the ones the board shows as their a-z letters, grouped by number
+ * of letters and ranked by letters as the index buckets.
+ *
+ * Returns: (transfer full): the dictionary
+ */
+MuttumDictionary *muttum_dictionary_new (
+    MuttumDictionaryIndex *index,
+    MuttumDictionaryBackend backend)
+{
+  MuttumDictionary *dictionary = g_new0(MuttumDictionary, 1);
+  dictionary->backend = backend;
+
+  switch (backend) {
+    case MUTTUM_DICTIONARY_BACKEND_AUTOMATON:
+      muttum_dictionary_build_automaton(dictionary, index);
+      muttum_dictionary_index_free(index);
+      break;
+    case MUTTUM_DICTIONARY_BACKEND_INDEX:
+    default:
+      dictionary->index = index;
+      break;
+  }
+
+  return dictionary;
+}
+
+void muttum_dictionary_free (MuttumDictionary *dictionary)
+{
+  if (!dictionary) {
+    return;
+  }
+
+  muttum_dictionary_index_free(dictionary->index);
+  muttum_automaton_free(dictionary->automaton);
+  g_free(dictionary->guess_keys);
+  g_free(dictionary->spellings);
+  g_free(dictionary->spelling_words);
+  g_free(dictionary);
+}
+
+MuttumDictionaryBackend muttum_dictionary_get_backend (MuttumDictionary *dictionary)
+{
+  return dictionary->backend;
+}
+
+/*
+ * muttum_dictionary_get_size:
+ *
+ * Returns: number of bytes used by the lexicon, mapped or allocated
+ */
+gsize muttum_dictionary_get_size (MuttumDictionary *dictionary)
+{
+  if (dictionary->backend == MUTTUM_DICTIONARY_BACKEND_AUTOMATON) {
+    return muttum_automaton_get_size(dictionary->automaton)
+      + dictionary->n_guess_keys * sizeof(guint64)
+      + dictionary->n_spellings * sizeof(MuttumDictionarySpelling)
+      + dictionary->spelling_words_size;
+  }
+
+  return muttum_dictionary_index_get_size(dictionary->index);
+}
+
+/*
+ * muttum_dictionary_get_n_collapsed:
+ *
+ * Returns: number of words of the word list dropped because they collapsed
+ * on the collation key of a previous word, or on its letters with the
+ * automaton backend
+ */
+guint muttum_dictionary_get_n_collapsed (MuttumDictionary *dictionary)
+{
+  if (dictionary->backend == MUTTUM_DICTIONARY_BACKEND_AUTOMATON) {
+    return dictionary->n_collapsed;
+  }
+
+  return dictionary->index->header->n_collapsed;
+}
+
+/*
+ * muttum_dictionary_contains:
+ * @key: a NUL terminated collation key
+ * @length: number of characters of the word
+ *
+ * The automaton backend only has words typed with a-z letters, looked up
+ * by muttum_dictionary_contains_folded(): it contains no other key.
+ */
+gboolean muttum_dictionary_contains (
+    MuttumDictionary *dictionary,
+    const guint8 *key,
+    guint length)
+{
+  if (dictionary->backend == MUTTUM_DICTIONARY_BACKEND_AUTOMATON) {
+    return FALSE;
+  }
+
+  return muttum_dictionary_index_lookup(dictionary->index, key) != NULL;
+}
+
+/*
+ * muttum_dictionary_contains_folded:
+ * @fold_key: a fold key from muttum_fold_pack()
+ *
+ * Same branch-free binary search as muttum_dictionary_index_lookup() on the
+ * fold keys: each step is a single integer compare and ICU isn't called.
+ * The automaton is walked along the letters of @fold_key, its few words
+ * which can only be guessed are searched the same way. Only words typeable
+ * with a-z letters have a fold key.
+ */
+gboolean muttum_dictionary_contains_folded (
+    MuttumDictionary *dictionary,
+    guint64 fold_key)
+{
+  if (fold_key == MUTTUM_FOLD_KEY_NONE) {
+    return FALSE;
+  }
+
+  const guint64 *base = NULL;
+  gsize n_keys = 0;
+
+  if (dictionary->backend == MUTTUM_DICTIONARY_BACKEND_AUTOMATON) {
+    guint8 symbols[1 + MUTTUM_FOLD_LENGTH_MAX];
+    guint n_letters = muttum_fold_unpack(fold_key, symbols + 1);
+
+    symbols[0] = n_letters;
+    if (muttum_automaton_lookup(dictionary->automaton, symbols, n_letters + 1) >= 0) {
+      return TRUE;
+    }
+    base = dictionary->guess_keys;
+    n_keys = dictionary->n_guess_keys;
+  } else {
+    base = dictionary->index->folded;
+    n_keys = dictionary->index->header->n_folded;
+  }
+
+  if (n_keys == 0) {
+    return FALSE;
+  }
+
+  while (n_keys > 1) {
+    gsize half = n_keys / 2;
+    base = base[half] <= fold_key ? base + half : base;
+    n_keys -= half;
+  }
+
+  return *base == fold_key;
+}
+
+guint muttum_dictionary_get_n_playable (
+    MuttumDictionary *dictionary,
+    guint length)
+{
+  if (dictionary->backend == MUTTUM_DICTIONARY_BACKEND_AUTOMATON) {
+    guint8 prefix = length;
+    guint first_rank = 0;
+    guint n_words = 0;
+
+    if (length <= MUTTUM_FOLD_LENGTH_MAX) {
+      muttum_automaton_get_prefix_range(dictionary->automaton, &prefix, 1, &first_rank, &n_words);
+    }
+    return n_words;
+  }
+
+  return muttum_dictionary_index_get_n_playable(dictionary->index, length);
+}
+
+/*
+ * Returns: the stored spelling of the word of automaton @rank, %NULL if
+ * it's spelled as its letters
+ */
+static const gchar *muttum_dictionary_find_spelling (
+    MuttumDictionary *dictionary,
+    guint rank)
+{
+  guint low = 0;
+  guint high = dictionary->n_spellings;
+
+  while (low < high) {
+    guint middle = low + (high - low) / 2;
+    if (dictionary->spellings[middle].rank < rank) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  if (low < dictionary->n_spellings && dictionary->spellings[low].rank == rank) {
+    return dictionary->spelling_words + dictionary->spellings[low].word;
+  }
+  return NULL;
+}
+
+/*
+ * muttum_dictionary_get_playable:
+ * @position: position of the word among playable words of @length characters
+ * @buffer: a caller allocated buffer of %MUTTUM_DICTIONARY_FOLDED_SIZE bytes,
+ *   used for words the automaton spells from their letters
+ *
+ * Returns: (transfer none): the original spelling of the word, @buffer or
+ * owned by @dictionary
+ */
+const gchar *muttum_dictionary_get_playable (
+    MuttumDictionary *dictionary,
+    guint length,
+    guint position,
+    gchar *buffer)
+{
+  if (dictionary->backend == MUTTUM_DICTIONARY_BACKEND_AUTOMATON) {
+    guint8 symbols[1 + MUTTUM_FOLD_LENGTH_MAX];
+    guint first_rank = 0;
+    guint n_words = 0;
+
+    symbols[0] = length;
+    if (length <= MUTTUM_FOLD_LENGTH_MAX) {
+      muttum_automaton_get_prefix_range(dictionary->automaton, symbols, 1, &first_rank, &n_words);
+    }
+    g_return_val_if_fail(position < n_words, NULL);
+
+    const gchar *spelling = muttum_dictionary_find_spelling(dictionary, first_rank + position);
+    if (spelling) {
+      return spelling;
+    }
+
+    muttum_automaton_get_word(dictionary->automaton, first_rank + position, symbols, sizeof(symbols));
+    for (guint i = 0; i < length; i += 1) {
+      buffer[i] = 'a' + symbols[i + 1] - 1;
+    }
+    buffer[length] = '\0';
+    return buffer;
+  }
+
+  const MuttumDictionaryIndexEntry *entry = muttum_dictionary_index_get_playable(dictionary->index, length, position);
+  return entry ? muttum_dictionary_index_get_word(dictionary->index, entry) : NULL;
+}
+
+/*
+ * muttum_dictionary_get_folded_playable:
+ * @transliterator: a transliterator from muttum_dictionary_open_transliterator()
+ *
+ * Only words folding to @length a-z letters are kept, they can be typed.
+ * The automaton has their letters, @transliterator isn't used.
+ *
+ * Returns: (transfer full): the concatenated folded playable words of
+ * @length letters, in dictionary order
+ */
+GByteArray *muttum_dictionary_get_folded_playable (
+    MuttumDictionary *dictionary,
+    UTransliterator *transliterator,
+    guint length)
+{
+  guint n_playable = muttum_dictionary_get_n_playable(dictionary, length);
+  GByteArray *words = g_byte_array_sized_new(n_playable * length);
+  gchar folded[MUTTUM_DICTIONARY_FOLDED_SIZE];
+
+  if (dictionary->backend == MUTTUM_DICTIONARY_BACKEND_AUTOMATON) {
+    guint8 symbols[1 + MUTTUM_FOLD_LENGTH_MAX];
+    guint first_rank = 0;
+    guint n_words = 0;
+
+    symbols[0] = length;
+    muttum_automaton_get_prefix_range(dictionary->automaton, symbols, 1, &first_rank, &n_words);
+
+    // Stored spellings aren't read, words are spelled from their letters
+    for (guint position = 0; position < n_playable; position += 1) {
+      muttum_automaton_get_word(dictionary->automaton, first_rank + position, symbols, sizeof(symbols));
+      for (guint i = 0; i < length; i += 1) {
+        folded[i] = 'a' + symbols[i + 1] - 1;
+      }
+      g_byte_array_append(words, (const guint8 *) folded, length);
+    }
+
+    return words;
+  }
+
+  for (guint position = 0; position < n_playable; position += 1) {
+    const gchar *word = muttum_dictionary_get_playable(dictionary, length, position, NULL);
+    gboolean is_typeable = muttum_dictionary_fold_word(transliterator, word, folded);
+
+    for (guint i = 0; i < length && is_typeable; i += 1) {
+      is_typeable = folded[i] >= 'a' && folded[i] <= 'z';
+    }
+
+    if (is_typeable && folded[length] == '\0') {
+      g_byte_array_append(words, (const guint8 *) folded, length);
+    }
+  }
+
+  return words;
+}
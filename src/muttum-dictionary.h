@@ -0,0 +1,189 @@
+/* muttum-dictionary.h
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <unicode/ucol.h>
+#include <unicode/utrans.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Private dictionary helpers shared by the engine and the
+ * muttum-dictionary-compile build tool.
+ * */
+
+#define MUTTUM_DICTIONARY_INDEX_MAGIC "MUTTUMIX"
+#define MUTTUM_DICTIONARY_INDEX_VERSION 5
+#define MUTTUM_DICTIONARY_LOCALE_SIZE 16
+#define MUTTUM_DICTIONARY_FOLDED_SIZE 100
+
+/*
+ * Binary index layout (host endianness, every section 8 bytes aligned):
+ *
+ *  - MuttumDictionaryIndexHeader
+ *  - entries: n_words MuttumDictionaryIndexEntry sorted by collation key
+ *  - buckets: guint32 bucket boundaries for each word length followed by
+ *    the guint32 entry positions of playable words grouped by length and
+ *    sorted by fold key. Playable words are shown by the board as their
+ *    a-z letters, one spelling by letters.
+ *  - keys: NUL terminated collation keys, referenced by entry->key
+ *  - words: NUL terminated original spellings, referenced by entry->word
+ *  - folded: sorted guint64 fold keys of the words typeable with a-z
+ *    letters, see muttum-fold.h
+ * */
+typedef struct {
+  gchar magic[8];
+  guint32 version;
+  guint32 n_words;
+  gchar locale[MUTTUM_DICTIONARY_LOCALE_SIZE];
+  guint8 collator_version[U_MAX_VERSION_LENGTH];
+  guint32 word_length_min;
+  guint32 word_length_max;
+  // Words dropped as their collation key was the one of a previous word
+  guint32 n_collapsed;
+  guint64 source_size;
+  guint64 source_mtime;
+  guint64 entries_offset;
+  guint64 buckets_offset;
+  guint64 buckets_size;
+  guint64 keys_offset;
+  guint64 keys_size;
+  guint64 words_offset;
+  guint64 words_size;
+  guint64 folded_offset;
+  guint64 n_folded;
+} MuttumDictionaryIndexHeader;
+
+typedef struct {
+  guint32 key;
+  guint32 word;
+  guint8 length;
+  guint8 is_playable;
+  guint16 padding;
+} MuttumDictionaryIndexEntry;
+
+typedef struct _MuttumDictionaryIndex MuttumDictionaryIndex;
+
+/*
+ * In memory representations of the lexicon:
+ *  - index: the sorted index, mapped or built in memory
+ *  - automaton: a minimized automaton over the letters of the words typed
+ *    with a-z letters, smaller but slower to build
+ * */
+typedef enum {
+  MUTTUM_DICTIONARY_BACKEND_INDEX,
+  MUTTUM_DICTIONARY_BACKEND_AUTOMATON,
+} MuttumDictionaryBackend;
+
+typedef struct _MuttumDictionary MuttumDictionary;
+
+UCollator *muttum_dictionary_open_collator (const gchar *locale);
+
+UTransliterator *muttum_dictionary_open_transliterator (void);
+
+gboolean muttum_dictionary_fold_word (UTransliterator *transliterator,
+                                      const gchar *word,
+                                      gchar *folded);
+
+guint8 *muttum_dictionary_compute_key (UCollator *collator,
+                                       const gchar *word,
+                                       guint8 *buffer,
+                                       gsize buffer_size,
+                                       gsize *key_size);
+
+gboolean muttum_dictionary_index_write (GFile *source,
+                                        const gchar *locale,
+                                        guint word_length_min,
+                                        guint word_length_max,
+                                        const gchar *output_path,
+                                        GError **error);
+
+MuttumDictionaryIndex *muttum_dictionary_index_new (GFile *source,
+                                                    const gchar *locale,
+                                                    guint word_length_min,
+                                                    guint word_length_max,
+                                                    GError **error);
+
+MuttumDictionaryIndex *muttum_dictionary_index_open (const gchar *path,
+                                                     GFile *source,
+                                                     UCollator *collator,
+                                                     const gchar *locale,
+                                                     guint word_length_min,
+                                                     guint word_length_max,
+                                                     GError **error);
+
+void muttum_dictionary_index_free (MuttumDictionaryIndex *index);
+
+guint muttum_dictionary_index_get_n_words (MuttumDictionaryIndex *index);
+
+const MuttumDictionaryIndexEntry *muttum_dictionary_index_get_entry (MuttumDictionaryIndex *index,
+                                                                     guint position);
+
+guint muttum_dictionary_index_get_n_playable (MuttumDictionaryIndex *index,
+                                              guint length);
+
+const MuttumDictionaryIndexEntry *muttum_dictionary_index_get_playable (MuttumDictionaryIndex *index,
+                                                                        guint length,
+                                                                        guint position);
+
+const gchar *muttum_dictionary_index_get_word (MuttumDictionaryIndex *index,
+                                               const MuttumDictionaryIndexEntry *entry);
+
+const MuttumDictionaryIndexEntry *muttum_dictionary_index_lookup (MuttumDictionaryIndex *index,
+                                                                  const guint8 *key);
+
+gsize muttum_dictionary_index_get_size (MuttumDictionaryIndex *index);
+
+MuttumDictionaryBackend muttum_dictionary_backend_from_string (const gchar *name);
+
+MuttumDictionary *muttum_dictionary_new (MuttumDictionaryIndex *index,
+                                         MuttumDictionaryBackend backend);
+
+void muttum_dictionary_free (MuttumDictionary *dictionary);
+
+MuttumDictionaryBackend muttum_dictionary_get_backend (MuttumDictionary *dictionary);
+
+gsize muttum_dictionary_get_size (MuttumDictionary *dictionary);
+
+guint muttum_dictionary_get_n_collapsed (MuttumDictionary *dictionary);
+
+gboolean muttum_dictionary_contains (MuttumDictionary *dictionary,
+                                     const guint8 *key,
+                                     guint length);
+
+gboolean muttum_dictionary_contains_folded (MuttumDictionary *dictionary,
+                                            guint64 fold_key);
+
+guint muttum_dictionary_get_n_playable (MuttumDictionary *dictionary,
+                                        guint length);
+
+const gchar *muttum_dictionary_get_playable (MuttumDictionary *dictionary,
+                                             guint length,
+                                             guint position,
+                                             gchar *buffer);
+
+GByteArray *muttum_dictionary_get_folded_playable (MuttumDictionary *dictionary,
+                                                  UTransliterator *transliterator,
+                                                  guint length);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MuttumDictionaryIndex, muttum_dictionary_index_free)
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MuttumDictionary, muttum_dictionary_free)
+
+G_END_DECLS
@@ -17,6 +17,7 @@
  */
 
 #include <gio/gio.h>
+#include <string.h>
 #include <unicode/ucol.h>
 #include <unicode/utrans.h>
 #include <unicode/ustring.h>
@@ -26,63 +27,266 @@
 #include <glib/gi18n.h>
 
 #include "muttum-engine.h"
+#include "muttum-dictionary.h"
+#include "muttum-fold.h"
+#include "muttum-lexicon.h"
+#include "muttum-score.h"
+#include "muttum-solver.h"
+#include "muttum-trace.h"
 
 // Default French dictionary path uri if not defined
 #ifndef FRENCH_DICTIONARY_PATH_URI
   #define FRENCH_DICTIONARY_PATH_URI "file:///use/share/dict/french"
 #endif
 
+// Default precompiled dictionary index path if not defined
+#ifndef FRENCH_DICTIONARY_INDEX_PATH
+  #define FRENCH_DICTIONARY_INDEX_PATH "/usr/share/muttum/french.muttumdict"
+#endif
+
+// Default precomputed pattern matrices directory if not defined
+#ifndef FRENCH_PATTERN_MATRIX_DIR
+  #define FRENCH_PATTERN_MATRIX_DIR "/usr/share/muttum/patterns"
+#endif
+
+// Default geometry, see the rows and word-length-* properties
 const guint MUTTUM_ENGINE_ROWS = 6;
 const gchar MUTTUM_ENGINE_NULL_LETTER = '.';
 const guint MUTTUM_ENGINE_WORD_LENGTH_MIN = 5;
 const guint MUTTUM_ENGINE_WORD_LENGTH_MAX = 8;
 const guint MUTTUM_ENGINE_UCHAR_BUFFER_SIZE = 100;
 
-// Muttum is currently only developped for French users
+// Default words, other locales and word lists are given by engine properties
 const gchar *MUTTUM_ENGINE_COLLATION = "fr_FR";
 const gchar *MUTTUM_ENGINE_DICTIONARY_FILE_URI = FRENCH_DICTIONARY_PATH_URI;
+const gchar *MUTTUM_ENGINE_DICTIONARY_INDEX_PATH = FRENCH_DICTIONARY_INDEX_PATH;
+const gchar *MUTTUM_ENGINE_PATTERN_MATRIX_DIR = FRENCH_PATTERN_MATRIX_DIR;
 
-static GTree *muttum_engine_class_dictionary_init(UCollator *collator);
+static gboolean muttum_engine_lexicon_init(MuttumEngine *self, GError **error);
 static void muttum_engine_word_init(MuttumEngine* self);
-static GPtrArray *muttum_engine_alphabet_init(GString *word);
-static GPtrArray *muttum_engine_board_init(GString *word);
+static void muttum_engine_word_set(MuttumEngine *self, const gchar *dictionary_word);
+static void muttum_engine_alphabet_init(MuttumEngine *self);
+static void muttum_engine_board_init(MuttumEngine *self);
+static void muttum_engine_candidates_init(MuttumEngine *self);
+static void muttum_engine_game_init(MuttumEngine *self);
+static gboolean muttum_engine_game_restore(MuttumEngine *self, GBytes *bytes, GError **error);
+static guint32 muttum_engine_row_apply(MuttumEngine *self, MuttumLetter *row, guint64 guess, guint16 pattern);
 
 G_DEFINE_QUARK(muttum-engine-error-quark, muttum_engine_error);
 
+GType
+muttum_engine_length_distribution_get_type (void)
+{
+  static gsize type_id = 0;
+
+  if (g_once_init_enter(&type_id)) {
+    static const GEnumValue values[] = {
+      { MUTTUM_ENGINE_LENGTH_DISTRIBUTION_UNIFORM, "MUTTUM_ENGINE_LENGTH_DISTRIBUTION_UNIFORM", "uniform" },
+      { MUTTUM_ENGINE_LENGTH_DISTRIBUTION_DICTIONARY, "MUTTUM_ENGINE_LENGTH_DISTRIBUTION_DICTIONARY", "dictionary" },
+      { 0, NULL, NULL },
+    };
+    GType type = g_enum_register_static(g_intern_static_string("MuttumEngineLengthDistribution"), values);
+    g_once_init_leave(&type_id, type);
+  }
+
+  return type_id;
+}
+
+enum {
+  PROP_0,
+  PROP_LENGTH_DISTRIBUTION,
+  PROP_LOCALE,
+  PROP_DICTIONARY_URI,
+  PROP_SAVED_GAME,
+  PROP_ROWS,
+  PROP_WORD_LENGTH_MIN,
+  PROP_WORD_LENGTH_MAX,
+  N_PROPERTIES,
+};
+
+static GParamSpec *properties[N_PROPERTIES] = { NULL, };
+
+enum {
+  SIGNAL_CELL_CHANGED,
+  SIGNAL_ROW_VALIDATED,
+  SIGNAL_ALPHABET_CHANGED,
+  N_SIGNALS,
+};
+
+static guint signals[N_SIGNALS] = { 0, };
+
 typedef struct {
   gchar letter;
   MuttumLetterState state;
-  guint found;
-  GPtrArray *position;
 } MuttumLetterPrivate;
 
+/*
+ * Saved game, see muttum_engine_serialize(). Integers are little endian.
+ * Only the rows up to the current one are stored, the other bytes are 0.
+ */
+#define MUTTUM_ENGINE_SAVE_MAGIC "MTMG"
+#define MUTTUM_ENGINE_SAVE_VERSION 1
+// Games of more rows can't be saved, longer words aren't supported
+#define MUTTUM_ENGINE_SAVE_ROWS 6
+#define MUTTUM_ENGINE_SAVE_LENGTH 8
+
 typedef struct {
-  GString* word;
-  gboolean is_playable;
-} DictionaryWord;
+  gchar magic[4];
+  guint8 version;
+  guint8 length;
+  guint8 current_row;
+  guint8 state;
+  // Position of the word among the playable words of its length
+  guint32 word_index;
+  // Hash of the dictionary spelling of the word, so that a changed word
+  // list doesn't resume the game with another word
+  guint32 word_hash;
+  // Patterns of the validated rows, see muttum_score_word()
+  guint16 patterns[MUTTUM_ENGINE_SAVE_ROWS];
+  // Letters of the rows, MUTTUM_ENGINE_NULL_LETTER for the empty cells
+  gchar letters[MUTTUM_ENGINE_SAVE_ROWS][MUTTUM_ENGINE_SAVE_LENGTH];
+} MuttumEngineSave;
+
+G_STATIC_ASSERT(sizeof(MuttumEngineSave) == 76);
 
 struct _MuttumEngine
 {
   GObject parent_instance;
 
   // Engine properties
+  gchar *locale;
+  gchar *dictionary_uri;
   GString *word;
   GString *dictionary_word;
-  GPtrArray *alphabet;
-  GPtrArray *board;
+  // Position of the word among the playable words of its length
+  guint word_index;
+  // Letters from a to z
+  MuttumLetterPrivate alphabet[26];
+  // Board geometry, construct-only
+  guint rows;
+  guint word_length_min;
+  guint word_length_max;
+  // rows rows of length letters, row after row. Allocated once for the
+  // longest words, so muttum_engine_reset() reuses it
+  MuttumLetter *board;
+  guint length;
   guint current_row;
   MuttumEngineState state;
+  MuttumEngineLengthDistribution length_distribution;
+
+  // Words of the engine locale, shared with every engine of the same
+  // locale and word list
+  MuttumLexicon *lexicon;
+
+  // Words still consistent with the validated rows, narrowed by each
+  // muttum_engine_validate()
+  MuttumSolverCandidates *candidates;
+
+  // Game to resume at construction, and why it couldn't be
+  GBytes *saved_game;
+  GError *restore_error;
+
+  // Validations and word selections of this engine, dictionary fields are
+  // read from the lexicon
+  MuttumEngineStats stats;
 };
 
+typedef struct {
+  MuttumSolverCandidates *candidates;
+  gint64 position;
+  gchar word[16];
+} MuttumEngineRealCandidateIter;
+
+G_STATIC_ASSERT(sizeof(MuttumEngineRealCandidateIter) == sizeof(MuttumEngineCandidateIter));
+G_STATIC_ASSERT(sizeof(((MuttumEngineRealCandidateIter *) NULL)->word) > MUTTUM_SOLVER_LENGTH_MAX);
+
 struct _MuttumEngineClass {
   GObjectClass parent_class;
-
-  // Class Members
-  GTree *dictionary;
-  UCollator *collator;
 };
 
-G_DEFINE_TYPE(MuttumEngine, muttum_engine, G_TYPE_OBJECT);
+static void muttum_engine_initable_iface_init(GInitableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(MuttumEngine, muttum_engine, G_TYPE_OBJECT,
+    G_IMPLEMENT_INTERFACE(G_TYPE_INITABLE, muttum_engine_initable_iface_init));
+
+G_STATIC_ASSERT(MUTTUM_SOLVER_LENGTH_MAX <= MUTTUM_ENGINE_STATS_LENGTH_MAX);
+G_STATIC_ASSERT(MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MAX <= MUTTUM_SCORE_WORD_LENGTH_MAX);
+G_STATIC_ASSERT(MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MAX <= MUTTUM_ENGINE_SAVE_LENGTH);
+
+/*
+ * Validations and word selections of every engine run by one thread. Hot
+ * paths only write the block of their thread without lock, and
+ * muttum_engine_get_class_stats() sums the blocks: counters are read and
+ * written with relaxed atomics so the sum never sees a torn value.
+ */
+typedef struct {
+  guint64 n_validations;
+  guint64 validation_latency[MUTTUM_ENGINE_STATS_LATENCY_BUCKETS];
+  guint64 n_word_selections;
+  guint64 word_selection_time;
+} MuttumEngineThreadStats;
+
+// Blocks of the running threads, and the sum of the exited ones
+static GMutex muttum_engine_class_stats_mutex;
+static GSList *muttum_engine_thread_stats;
+static MuttumEngineThreadStats muttum_engine_exited_stats;
+
+static void muttum_engine_thread_stats_free(gpointer data);
+static GPrivate muttum_engine_thread_stats_key = G_PRIVATE_INIT(muttum_engine_thread_stats_free);
+
+static inline guint64 muttum_engine_counter_get(const guint64 *counter) {
+  return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+/*
+ * Only the thread of the block writes its counters, a load and a store are
+ * enough.
+ */
+static inline void muttum_engine_counter_add(guint64 *counter, guint64 value) {
+  __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+}
+
+static void muttum_engine_thread_stats_sum(MuttumEngineThreadStats *sum, const MuttumEngineThreadStats *stats) {
+  sum->n_validations += muttum_engine_counter_get(&stats->n_validations);
+  for (guint i = 0; i < MUTTUM_ENGINE_STATS_LATENCY_BUCKETS; i += 1) {
+    sum->validation_latency[i] += muttum_engine_counter_get(&stats->validation_latency[i]);
+  }
+  sum->n_word_selections += muttum_engine_counter_get(&stats->n_word_selections);
+  sum->word_selection_time += muttum_engine_counter_get(&stats->word_selection_time);
+}
+
+/*
+ * Runs when a thread exits: its counters are kept in the exited sum.
+ */
+static void muttum_engine_thread_stats_free(gpointer data) {
+  MuttumEngineThreadStats *stats = data;
+
+  g_mutex_lock(&muttum_engine_class_stats_mutex);
+  muttum_engine_thread_stats_sum(&muttum_engine_exited_stats, stats);
+  muttum_engine_thread_stats = g_slist_remove(muttum_engine_thread_stats, stats);
+  g_mutex_unlock(&muttum_engine_class_stats_mutex);
+
+  g_free(stats);
+}
+
+/*
+ * Returns: (transfer none): the counters of the current thread, the lock is
+ * only taken by the first call of a thread
+ */
+static MuttumEngineThreadStats *muttum_engine_get_thread_stats(void) {
+  MuttumEngineThreadStats *stats = g_private_get(&muttum_engine_thread_stats_key);
+
+  if (G_UNLIKELY(!stats)) {
+    stats = g_new0(MuttumEngineThreadStats, 1);
+    g_private_set(&muttum_engine_thread_stats_key, stats);
+
+    g_mutex_lock(&muttum_engine_class_stats_mutex);
+    muttum_engine_thread_stats = g_slist_prepend(muttum_engine_thread_stats, stats);
+    g_mutex_unlock(&muttum_engine_class_stats_mutex);
+  }
+
+  return stats;
+}
 
 static void
 muttum_engine_dispose (GObject *gobject)
@@ -90,10 +294,7 @@ muttum_engine_dispose (GObject *gobject)
   MUTTUM_IS_ENGINE(gobject);
   MuttumEngine *self = MUTTUM_ENGINE(gobject);
 
-  g_ptr_array_unref(self->alphabet);
-
-  // Board is initialized to cascade unref to rows and free letters
-  g_ptr_array_unref(self->board);
+  g_clear_pointer(&self->board, g_free);
 
   G_OBJECT_CLASS (muttum_engine_parent_class)->dispose (gobject);
 }
@@ -104,290 +305,516 @@ muttum_engine_finalize (GObject *gobject)
   MUTTUM_IS_ENGINE(gobject);
   MuttumEngine *self = MUTTUM_ENGINE(gobject);
 
-  g_string_free(self->word, TRUE);
-  g_string_free(self->dictionary_word, TRUE);
+  if (self->word) {
+    g_string_free(self->word, TRUE);
+    g_string_free(self->dictionary_word, TRUE);
+  }
+  muttum_solver_candidates_free(self->candidates);
+  // Last engine of a locale evicts its words
+  muttum_lexicon_release(self->lexicon);
+  g_free(self->locale);
+  g_free(self->dictionary_uri);
+  g_clear_pointer(&self->saved_game, g_bytes_unref);
+  g_clear_error(&self->restore_error);
 
   G_OBJECT_CLASS (muttum_engine_parent_class)->finalize (gobject);
 }
 
+static void
+muttum_engine_set_property (GObject *gobject,
+    guint property_id,
+    const GValue *value,
+    GParamSpec *pspec)
+{
+  MuttumEngine *self = MUTTUM_ENGINE(gobject);
+
+  switch (property_id) {
+    case PROP_LENGTH_DISTRIBUTION:
+      self->length_distribution = g_value_get_enum(value);
+      break;
+    case PROP_LOCALE:
+      g_free(self->locale);
+      self->locale = g_value_dup_string(value);
+      break;
+    case PROP_DICTIONARY_URI:
+      g_free(self->dictionary_uri);
+      self->dictionary_uri = g_value_dup_string(value);
+      break;
+    case PROP_SAVED_GAME:
+      g_clear_pointer(&self->saved_game, g_bytes_unref);
+      self->saved_game = g_value_dup_boxed(value);
+      break;
+    case PROP_ROWS:
+      self->rows = g_value_get_uint(value);
+      break;
+    case PROP_WORD_LENGTH_MIN:
+      self->word_length_min = g_value_get_uint(value);
+      break;
+    case PROP_WORD_LENGTH_MAX:
+      self->word_length_max = g_value_get_uint(value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+      break;
+  }
+}
+
+static void
+muttum_engine_get_property (GObject *gobject,
+    guint property_id,
+    GValue *value,
+    GParamSpec *pspec)
+{
+  MuttumEngine *self = MUTTUM_ENGINE(gobject);
+
+  switch (property_id) {
+    case PROP_LENGTH_DISTRIBUTION:
+      g_value_set_enum(value, self->length_distribution);
+      break;
+    case PROP_LOCALE:
+      g_value_set_string(value, self->locale);
+      break;
+    case PROP_DICTIONARY_URI:
+      g_value_set_string(value, self->dictionary_uri);
+      break;
+    case PROP_ROWS:
+      g_value_set_uint(value, self->rows);
+      break;
+    case PROP_WORD_LENGTH_MIN:
+      g_value_set_uint(value, self->word_length_min);
+      break;
+    case PROP_WORD_LENGTH_MAX:
+      g_value_set_uint(value, self->word_length_max);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+      break;
+  }
+}
+
+static void
+muttum_engine_constructed (GObject *gobject)
+{
+  MuttumEngine *self = MUTTUM_ENGINE(gobject);
+
+  if (self->word_length_min > self->word_length_max) {
+    g_warning("MuttumEngine: word-length-min %u is greater than word-length-max %u, using %u",
+        self->word_length_min, self->word_length_max, self->word_length_max);
+    self->word_length_min = self->word_length_max;
+  }
+
+  G_OBJECT_CLASS (muttum_engine_parent_class)->constructed (gobject);
+}
+
+/*
+ * Loads the words and starts the game, the engine can't be used when its
+ * words couldn't be loaded.
+ */
+static gboolean
+muttum_engine_initable_init (GInitable *initable,
+    G_GNUC_UNUSED GCancellable *cancellable,
+    GError **error)
+{
+  MuttumEngine *self = MUTTUM_ENGINE(initable);
+
+  // Init may run again, the game is only started once
+  if (self->lexicon) {
+    return TRUE;
+  }
+
+  // Word selection depends on construct properties
+  if (!muttum_engine_lexicon_init(self, error)) {
+    g_clear_pointer(&self->saved_game, g_bytes_unref);
+    return FALSE;
+  }
+
+  // Game state is allocated once, each game reuses it
+  self->word = g_string_sized_new(MUTTUM_DICTIONARY_FOLDED_SIZE);
+  self->dictionary_word = g_string_sized_new(MUTTUM_DICTIONARY_FOLDED_SIZE);
+  self->board = g_new(MuttumLetter, self->rows * self->word_length_max);
+
+  if (self->saved_game && muttum_engine_game_restore(self, self->saved_game, &self->restore_error)) {
+    g_debug("MuttumEngine: game resumed at row %u", self->current_row);
+  } else {
+    if (self->restore_error) {
+      g_debug("MuttumEngine: unable to resume the saved game: %s", self->restore_error->message);
+    }
+    muttum_engine_game_init(self);
+  }
+  g_clear_pointer(&self->saved_game, g_bytes_unref);
+
+  return TRUE;
+}
+
+static void
+muttum_engine_initable_iface_init (GInitableIface *iface)
+{
+  iface->init = muttum_engine_initable_init;
+}
+
 static void
 muttum_engine_class_init(MuttumEngineClass *klass) {
   GObjectClass *g_object_class = G_OBJECT_CLASS(klass);
 
   // Override methods
+  g_object_class->set_property = muttum_engine_set_property;
+  g_object_class->get_property = muttum_engine_get_property;
+  g_object_class->constructed = muttum_engine_constructed;
   g_object_class->dispose = muttum_engine_dispose;
   g_object_class->finalize = muttum_engine_finalize;
 
-  // Setup class members
+  /**
+   * MuttumEngine:length-distribution:
+   *
+   * How the length of the word to find is chosen.
+   */
+  properties[PROP_LENGTH_DISTRIBUTION] = g_param_spec_enum(
+      "length-distribution", "Length distribution",
+      "How the length of the word to find is chosen",
+      MUTTUM_TYPE_ENGINE_LENGTH_DISTRIBUTION,
+      MUTTUM_ENGINE_LENGTH_DISTRIBUTION_UNIFORM,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * MuttumEngine:locale:
+   *
+   * Collation locale of the words, for instance "fr_FR".
+   */
+  properties[PROP_LOCALE] = g_param_spec_string(
+      "locale", "Locale",
+      "Collation locale of the words",
+      MUTTUM_ENGINE_COLLATION,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * MuttumEngine:dictionary-uri:
+   *
+   * URI of the word list, one word by line. When %NULL, the French word
+   * list and its precompiled index are used, they can be overridden by the
+   * `MUTTUM_DICTIONARY_URI` and `MUTTUM_DICTIONARY_INDEX` environment
+   * variables.
+   *
+   * Engines of the same locale and word list share their words, they are
+   * loaded by the first engine and freed with the last one.
+   */
+  properties[PROP_DICTIONARY_URI] = g_param_spec_string(
+      "dictionary-uri", "Dictionary URI",
+      "URI of the word list",
+      NULL,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * MuttumEngine:saved-game:
+   *
+   * Game to resume, saved by muttum_engine_serialize() with the same locale
+   * and word list. A new game is started if it can't be resumed, use
+   * muttum_engine_deserialize() to know why.
+   */
+  properties[PROP_SAVED_GAME] = g_param_spec_boxed(
+      "saved-game", "Saved game",
+      "Game to resume",
+      G_TYPE_BYTES,
+      G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * MuttumEngine:rows:
+   *
+   * Number of tries to find the word. Games of more than 6 rows can't be
+   * saved.
+   */
+  properties[PROP_ROWS] = g_param_spec_uint(
+      "rows", "Rows",
+      "Number of tries to find the word",
+      1, MUTTUM_ENGINE_ROWS_MAX, MUTTUM_ENGINE_ROWS,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * MuttumEngine:word-length-min:
+   *
+   * Shortest word to find. Engines of other word lengths than the default
+   * ones don't share the words of default engines, and their dictionary
+   * index is built at runtime.
+   */
+  properties[PROP_WORD_LENGTH_MIN] = g_param_spec_uint(
+      "word-length-min", "Shortest word length",
+      "Shortest word to find",
+      MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MIN, MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MAX,
+      MUTTUM_ENGINE_WORD_LENGTH_MIN,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * MuttumEngine:word-length-max:
+   *
+   * Longest word to find, at least #MuttumEngine:word-length-min.
+   */
+  properties[PROP_WORD_LENGTH_MAX] = g_param_spec_uint(
+      "word-length-max", "Longest word length",
+      "Longest word to find",
+      MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MIN, MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MAX,
+      MUTTUM_ENGINE_WORD_LENGTH_MAX,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties(g_object_class, N_PROPERTIES, properties);
+
+  /**
+   * MuttumEngine::cell-changed:
+   * @engine: the engine
+   * @row: the 0-based row of the cell
+   * @col: the 0-based column of the cell
+   *
+   * Emitted when a letter is added to or removed from the board, and when
+   * the first letter of the next row is given.
+   */
+  signals[SIGNAL_CELL_CHANGED] = g_signal_new(
+      "cell-changed",
+      G_TYPE_FROM_CLASS(klass),
+      G_SIGNAL_RUN_LAST,
+      0, NULL, NULL, NULL,
+      G_TYPE_NONE, 2, G_TYPE_UINT, G_TYPE_UINT);
+
+  /**
+   * MuttumEngine::row-validated:
+   * @engine: the engine
+   * @row: the 0-based row validated
+   *
+   * Emitted once the states of every letter of @row are set, after the
+   * other signals of the validation. Letters of @row don't emit
+   * #MuttumEngine::cell-changed.
+   */
+  signals[SIGNAL_ROW_VALIDATED] = g_signal_new(
+      "row-validated",
+      G_TYPE_FROM_CLASS(klass),
+      G_SIGNAL_RUN_LAST,
+      0, NULL, NULL, NULL,
+      G_TYPE_NONE, 1, G_TYPE_UINT);
+
+  /**
+   * MuttumEngine::alphabet-changed:
+   * @engine: the engine
+   * @letter: the letter of the alphabet, from 'a' to 'z'
+   *
+   * Emitted when the state of @letter in the alphabet changes, see
+   * muttum_engine_get_letter_state().
+   */
+  signals[SIGNAL_ALPHABET_CHANGED] = g_signal_new(
+      "alphabet-changed",
+      G_TYPE_FROM_CLASS(klass),
+      G_SIGNAL_RUN_LAST,
+      0, NULL, NULL, NULL,
+      G_TYPE_NONE, 1, G_TYPE_CHAR);
+}
 
-  // Unicode collator give more tools to create dictionary
-  UErrorCode status = U_ZERO_ERROR;
-  klass->collator = ucol_open(MUTTUM_ENGINE_COLLATION, &status);
+/*
+ * Acquires the words of the engine locale from the lexicon registry, they
+ * are loaded by the first engine using them.
+ *
+ * Returns: %FALSE if the words couldn't be loaded or have no playable word
+ * of the engine lengths
+ */
+static gboolean
+muttum_engine_lexicon_init(MuttumEngine *self, GError **error) {
+  MuttumLexiconSource source = {
+    .locale = self->locale ? self->locale : MUTTUM_ENGINE_COLLATION,
+    .dictionary_uri = self->dictionary_uri,
+    .word_length_min = self->word_length_min,
+    .word_length_max = self->word_length_max,
+  };
+
+  if (!source.dictionary_uri) {
+    // Dictionary paths can be overridden at runtime, for instance to run
+    // benchmarks against a fixed word list
+    const gchar *dictionary_uri = g_getenv("MUTTUM_DICTIONARY_URI");
+    const gchar *dictionary_index_path = g_getenv("MUTTUM_DICTIONARY_INDEX");
+    const gchar *pattern_matrix_dir = g_getenv("MUTTUM_PATTERN_MATRIX_DIR");
+
+    source.dictionary_uri = dictionary_uri ? dictionary_uri : MUTTUM_ENGINE_DICTIONARY_FILE_URI;
+    source.index_path = dictionary_index_path ? dictionary_index_path : MUTTUM_ENGINE_DICTIONARY_INDEX_PATH;
+    source.pattern_matrix_dir = pattern_matrix_dir ? pattern_matrix_dir : MUTTUM_ENGINE_PATTERN_MATRIX_DIR;
+    source.pattern_matrix_name = "french";
+  }
 
-  if (U_FAILURE(status)) {
-    g_error("Unable to open unicode collator");
+  self->lexicon = muttum_lexicon_acquire(&source, error);
+  if (!self->lexicon) {
+    return FALSE;
   }
 
-  // Primary strength allow to work with only base characters
-  // (neither case sensitive, nor accent sensitive)
-  ucol_setStrength(klass->collator, UCOL_PRIMARY);
+  // Every game needs a word to find
+  MuttumDictionary *dictionary = muttum_lexicon_get_dictionary(self->lexicon);
+  for (guint length = self->word_length_min; length <= self->word_length_max; length += 1) {
+    if (muttum_dictionary_get_n_playable(dictionary, length) > 0) {
+      return TRUE;
+    }
+  }
 
-  // Read the dictionary file once
-  klass->dictionary = muttum_engine_class_dictionary_init(klass->collator);
+  g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+      "No playable word of %u to %u letters in %s",
+      self->word_length_min, self->word_length_max, source.dictionary_uri);
+  g_clear_pointer(&self->lexicon, muttum_lexicon_release);
+  return FALSE;
 }
 
 static void
 muttum_engine_init(MuttumEngine *self) {
-  muttum_engine_word_init(self);
-  self->alphabet = muttum_engine_alphabet_init(self->word);
-  self->board = muttum_engine_board_init(self->word);
+  self->length_distribution = MUTTUM_ENGINE_LENGTH_DISTRIBUTION_UNIFORM;
+  self->rows = MUTTUM_ENGINE_ROWS;
+  self->word_length_min = MUTTUM_ENGINE_WORD_LENGTH_MIN;
+  self->word_length_max = MUTTUM_ENGINE_WORD_LENGTH_MAX;
   self->current_row = 0;
   self->state = MUTTUM_ENGINE_STATE_CONTINUE;
 }
 
-static void muttum_engine_dictionary_destroy_value(gpointer data) {
-  DictionaryWord* dword = data;
-  g_string_free(dword->word, TRUE);
-  g_free(dword);
-}
-
-static gint
-muttum_engine_dictionary_compare_word (
-    gconstpointer string1,
-    gconstpointer string2,
-    G_GNUC_UNUSED gpointer user_data
-) {
-  const char *first = string1;
-  const char *second = string2;
-  return g_strcmp0(first, second);
-}
+/*
+ * Picks a playable word from the per length buckets of the dictionary,
+ * following the engine length distribution. @index is set to the position
+ * of the word in its bucket, @buffer is given to muttum_dictionary_get_playable().
+ */
+static const gchar *muttum_engine_word_pick(MuttumEngine *self, MuttumDictionary *dictionary, guint *index, gchar *buffer) {
+  if (self->length_distribution == MUTTUM_ENGINE_LENGTH_DISTRIBUTION_DICTIONARY) {
+    guint n_words = 0;
+    for (guint length = self->word_length_min; length <= self->word_length_max; length += 1) {
+      n_words += muttum_dictionary_get_n_playable(dictionary, length);
+    }
 
-static GTree *muttum_engine_class_dictionary_init(UCollator *collator) {
-  GTree *dictionary = g_tree_new_full(
-      muttum_engine_dictionary_compare_word, NULL,
-      g_free, muttum_engine_dictionary_destroy_value);
-  GFile *dictionary_file = g_file_new_for_uri(MUTTUM_ENGINE_DICTIONARY_FILE_URI);
-  GError *error = NULL;
+    if (n_words == 0) {
+      return NULL;
+    }
 
-  // Open file for read
-  GFileInputStream *dictionary_stream = g_file_read(dictionary_file, NULL, &error);
-  if (!dictionary_stream) {
-    g_error("Error occured while opening dictionary: code: %d, message: %s", error->code, error->message);
-  }
-
-  gssize read;
-  gchar buffer[1024];
-  GString *word = g_string_new(NULL);
-
-  UChar u_word_buffer[MUTTUM_ENGINE_UCHAR_BUFFER_SIZE];
-  unsigned char key_buffer[MUTTUM_ENGINE_UCHAR_BUFFER_SIZE];
-  unsigned char* current_key_buffer = key_buffer;
-  uint32_t key_buffer_size = sizeof(key_buffer);
-  uint32_t key_buffer_expected_size = 0;
-
-  while(TRUE) {
-    read = g_input_stream_read(G_INPUT_STREAM(dictionary_stream), buffer, G_N_ELEMENTS(buffer), NULL, &error);
-    if (read > 0) {
-      for (guint i = 0; i < read; i += 1)
-      {
-        if (buffer[i] == '\n') {
-          glong word_length = g_utf8_strlen(word->str, -1);
-          if (word_length >= MUTTUM_ENGINE_WORD_LENGTH_MIN
-              && word_length <= MUTTUM_ENGINE_WORD_LENGTH_MAX) {
-            // Prepare value to store
-            DictionaryWord *dword = g_new(DictionaryWord, 1);
-            dword->is_playable = TRUE;
-            dword->word = word;
-
-            // Prepare key
-            u_uastrcpy(u_word_buffer, word->str);
-            key_buffer_expected_size = ucol_getSortKey(collator, u_word_buffer, -1, key_buffer, key_buffer_size);
-
-            if (key_buffer_expected_size > key_buffer_size) {
-              if (current_key_buffer == key_buffer) {
-                current_key_buffer = g_new(unsigned char, key_buffer_expected_size);
-              } else {
-                current_key_buffer = g_realloc_n(current_key_buffer, key_buffer_expected_size, sizeof(unsigned char));
-              }
-
-              key_buffer_size = ucol_getSortKey(collator, u_word_buffer, -1, current_key_buffer, key_buffer_expected_size);
-            }
-
-            unsigned char* key = g_new(unsigned char, key_buffer_size);
-            memcpy(key, key_buffer, key_buffer_size);
-
-            // Store key - value
-            g_tree_insert(dictionary, key, dword);
-
-            // Prepare word variable for next value
-            word = g_string_new(NULL);
-          } else {
-            g_string_erase(word, 0, -1);
-          }
-        } else {
-          word = g_string_append_c(word, buffer[i]);
-        }
+    guint position = g_random_int_range(0, n_words);
+    for (guint length = self->word_length_min; length <= self->word_length_max; length += 1) {
+      guint n_playable = muttum_dictionary_get_n_playable(dictionary, length);
+      if (position < n_playable) {
+        *index = position;
+        return muttum_dictionary_get_playable(dictionary, length, position, buffer);
       }
-    } else if (read < 0) {
-      g_error("Error occured while reading dictionary: code: %d, message: %s", error->code, error->message);
-    } else {
-      break;
+      position -= n_playable;
     }
-  }
 
-  if (current_key_buffer != key_buffer) {
-    g_free(current_key_buffer);
+    return NULL;
   }
 
-  g_input_stream_close(G_INPUT_STREAM(dictionary_stream), NULL, NULL);
+  // Lengths without playable words are never picked
+  guint n_lengths = 0;
+  for (guint length = self->word_length_min; length <= self->word_length_max; length += 1) {
+    n_lengths += muttum_dictionary_get_n_playable(dictionary, length) > 0;
+  }
 
-  return dictionary;
-}
+  if (n_lengths == 0) {
+    return NULL;
+  }
 
-static void muttum_engine_word_init(MuttumEngine* self) {
-  MuttumEngineClass* klass = MUTTUM_ENGINE_GET_CLASS(self);
-  guint offset = g_random_int_range(0, g_tree_nnodes(klass->dictionary));
-  guint word_length = g_random_int_range(MUTTUM_ENGINE_WORD_LENGTH_MIN, MUTTUM_ENGINE_WORD_LENGTH_MAX);
-  GTreeNode *node = g_tree_node_first(klass->dictionary);
-  GString *word = NULL;
-  // First lookup for word from random range
-  guint i = 0;
-  while (node)
-  {
-    DictionaryWord *dword = g_tree_node_value(node);
-    // Lookup first playable value from the random offset
-    if (i >= offset && dword->is_playable && g_utf8_strlen(dword->word->str, -1) == word_length) {
-      word = g_string_new(dword->word->str);
-      break;
+  guint choice = g_random_int_range(0, n_lengths);
+  for (guint length = self->word_length_min; length <= self->word_length_max; length += 1) {
+    guint n_playable = muttum_dictionary_get_n_playable(dictionary, length);
+    if (n_playable == 0) {
+      continue;
     }
-    i++;
-    node = g_tree_node_next(node);
-  }
-
-  // Second lookup from start (if random has given last value and its not playable)
-  if (!word) {
-    node = g_tree_node_first(klass->dictionary);
-    while (node)
-    {
-      DictionaryWord *dword = g_tree_node_value(node);
-      // Lookup first playable value from the random offset
-      if (dword->is_playable && g_utf8_strlen(dword->word->str, -1) == word_length) {
-        word = g_string_new(dword->word->str);
-        break;
-      }
-      node = g_tree_node_next(node);
+    if (choice == 0) {
+      *index = g_random_int_range(0, n_playable);
+      return muttum_dictionary_get_playable(dictionary, length, *index, buffer);
     }
+    choice -= 1;
   }
 
-  // Finally if word is still unknown give up
-  if (!word) {
+  return NULL;
+}
+
+static void muttum_engine_word_init(MuttumEngine* self) {
+  gint64 start_time = g_get_monotonic_time();
+  gint64 trace_time = MUTTUM_TRACE_BEGIN();
+  gchar buffer[MUTTUM_DICTIONARY_FOLDED_SIZE];
+  const gchar *dictionary_word = muttum_engine_word_pick(self, muttum_lexicon_get_dictionary(self->lexicon), &self->word_index, buffer);
+
+  // Engines without playable words fail their init
+  if (!dictionary_word) {
     g_error("Unable to find a word");
   }
 
-#ifdef MUTTUM_ENGINE_FORCE_WORD
-  g_string_erase(word, 0, -1);
-  g_string_append(word, MUTTUM_ENGINE_FORCE_WORD);
-#endif
+  muttum_engine_word_set(self, dictionary_word);
 
-  // Save the word from dictionary to display it in case of loose
-  self->dictionary_word = g_string_new(word->str);
+  gint64 duration = g_get_monotonic_time() - start_time;
+  self->stats.n_word_selections += 1;
+  self->stats.word_selection_time += duration;
 
-  // Transform the word to only base characters
-  UErrorCode status = U_ZERO_ERROR;
-  UChar transliterator_id [MUTTUM_ENGINE_UCHAR_BUFFER_SIZE];
-  u_uastrcpy(transliterator_id, "NFD; [:Nonspacing Mark:] Remove; Lower; NFC");
-  UTransliterator* transliterator = utrans_openU(
-    transliterator_id, -1,
-    UTRANS_FORWARD,
-    NULL, -1,
-    NULL,
-    &status);
-  if (U_FAILURE(status)) {
-    g_error("Unable to open unicode transliterator");
-  }
+  MuttumEngineThreadStats *thread_stats = muttum_engine_get_thread_stats();
+  muttum_engine_counter_add(&thread_stats->n_word_selections, 1);
+  muttum_engine_counter_add(&thread_stats->word_selection_time, duration);
 
-  UChar u_word[MUTTUM_ENGINE_UCHAR_BUFFER_SIZE];
-  u_uastrcpy(u_word, word->str);
-  int32_t u_word_limit = u_strlen(u_word);
-  utrans_transUChars(transliterator, u_word, NULL, MUTTUM_ENGINE_UCHAR_BUFFER_SIZE, 0, &u_word_limit, &status);
-  if (U_FAILURE(status)) {
-    g_error("Unable to transliterate");
-  }
-
-  utrans_close(transliterator);
+  MUTTUM_TRACE_END(trace_time, "word-init", "%" G_GSIZE_FORMAT " letters", self->word->len);
+}
 
-  // Save transliterated word
-  char trans_word[MUTTUM_ENGINE_UCHAR_BUFFER_SIZE];
-  u_austrcpy(trans_word, u_word);
+/*
+ * Sets the word to find from its dictionary spelling.
+ */
+static void muttum_engine_word_set(MuttumEngine *self, const gchar *dictionary_word) {
+  // Save the word from dictionary to display it in case of loose
+  g_string_assign(self->dictionary_word, dictionary_word);
 
-  g_string_erase(word, 0, -1);
-  g_string_append(word, trans_word);
+#ifdef MUTTUM_ENGINE_FORCE_WORD
+  g_string_assign(self->dictionary_word, MUTTUM_ENGINE_FORCE_WORD);
+#endif
 
-  self->word = word;
-}
+  // Transform the word to only base characters
+  gchar trans_word[MUTTUM_DICTIONARY_FOLDED_SIZE];
+  muttum_dictionary_fold_word(muttum_lexicon_get_transliterator(self->lexicon), self->dictionary_word->str, trans_word);
 
-static void muttum_engine_letter_private_free(gpointer data) {
-  MuttumLetterPrivate* letter = data;
-  g_ptr_array_unref(letter->position);
-  g_free(letter);
+  // Save transliterated word
+  g_string_assign(self->word, trans_word);
 }
 
-static GPtrArray *muttum_engine_alphabet_init(GString *word)
+static void muttum_engine_alphabet_init(MuttumEngine *self)
 {
-  GPtrArray *alphabet = g_ptr_array_new_full(
-      26,
-      muttum_engine_letter_private_free
-  );
+  for (guint i = 0; i < G_N_ELEMENTS(self->alphabet); i += 1)
+  {
+    self->alphabet[i].letter = 'a' + i;
+    self->alphabet[i].state = MUTTUM_LETTER_UNKOWN;
+  }
+}
 
-  glong word_length = g_utf8_strlen(word->str, -1);
+static void muttum_engine_board_init(MuttumEngine *self) {
+  self->length = g_utf8_strlen(self->word->str, -1);
+  g_assert(self->length <= self->word_length_max);
 
-  for (gchar i = 'a'; i <= 'z'; i += 1)
-  {
-    MuttumLetterPrivate *letter = g_new(MuttumLetterPrivate, 1);
-    letter->letter = i;
-    letter->position = g_ptr_array_new_with_free_func(g_free);
-    letter->found = 0;
-    letter->state = MUTTUM_LETTER_UNKOWN;
-    for (glong j = 0; j < word_length; j += 1)
-    {
-      if (i == word->str[j])
-      {
-        guint *position = g_new(guint, 1);
-        *position = j;
-        g_ptr_array_add(letter->position, position);
-      }
-    }
-    g_ptr_array_add(alphabet, letter);
+  for (guint i = 0; i < self->rows * self->length; i += 1) {
+    self->board[i].letter = MUTTUM_ENGINE_NULL_LETTER;
+    self->board[i].state = MUTTUM_LETTER_UNKOWN;
   }
+  self->board[0].letter = self->word->str[0];
+}
 
-  return alphabet;
+/*
+ * Picks a new word and clears the game state, without allocating once the
+ * engine is constructed.
+ */
+static void muttum_engine_game_init(MuttumEngine *self) {
+  muttum_engine_word_init(self);
+  muttum_engine_alphabet_init(self);
+  muttum_engine_board_init(self);
+  self->current_row = 0;
+  self->state = MUTTUM_ENGINE_STATE_CONTINUE;
+  muttum_engine_candidates_init(self);
 }
 
-static void muttum_engine_board_destroy_row(gpointer data) {
-  g_ptr_array_unref(data);
-}
-
-static GPtrArray *muttum_engine_board_init(GString *word) {
-  GPtrArray *board = g_ptr_array_new_full(
-      MUTTUM_ENGINE_ROWS,
-      muttum_engine_board_destroy_row
-  );
-  glong word_length = g_utf8_strlen(word->str, -1);
-  for (guint rowIndex = 0; rowIndex < MUTTUM_ENGINE_ROWS; rowIndex += 1) {
-    GPtrArray *row = g_ptr_array_new_full(word->len, g_free);
-    for (glong columnIndex = 0; columnIndex < word_length; columnIndex += 1) {
-      MuttumLetter *letter = g_new(MuttumLetter, 1);
-      if (rowIndex == 0 && columnIndex == 0) {
-        letter->letter = word->str[0];
-      } else {
-        letter->letter = MUTTUM_ENGINE_NULL_LETTER;
+/*
+ * Every word of the same length and first letter is a candidate at start.
+ * The first game sizes the candidates for the largest group of every word
+ * length, later games only reset them.
+ */
+static void muttum_engine_candidates_init(MuttumEngine *self) {
+  if (self->length <= MUTTUM_SOLVER_LENGTH_MAX) {
+    MuttumSolverLexicon *lexicon = muttum_lexicon_get_solver_lexicon(self->lexicon, self->length);
+    if (self->candidates) {
+      muttum_solver_candidates_reset(self->candidates, lexicon, self->word->str[0]);
+    } else {
+      self->candidates = muttum_solver_candidates_new(lexicon, self->word->str[0]);
+
+      for (guint length = self->word_length_min; length <= MIN(self->word_length_max, MUTTUM_SOLVER_LENGTH_MAX); length += 1) {
+        MuttumSolverLexicon *length_lexicon = muttum_lexicon_get_solver_lexicon(self->lexicon, length);
+        muttum_solver_candidates_reserve(self->candidates, muttum_solver_lexicon_get_first_letter_max(length_lexicon));
       }
-      letter->state = MUTTUM_LETTER_UNKOWN;
-      g_ptr_array_add(row, letter);
     }
-    g_ptr_array_add(board, row);
+  } else {
+    g_clear_pointer(&self->candidates, muttum_solver_candidates_free);
   }
-  return board;
 }
 
 static gpointer muttum_engine_board_copy_letter(gconstpointer src, G_GNUC_UNUSED gpointer data)
@@ -399,21 +826,380 @@ static gpointer muttum_engine_board_copy_letter(gconstpointer src, G_GNUC_UNUSED
   return copy;
 }
 
-static gpointer muttum_engine_board_copy_row (gconstpointer src, G_GNUC_UNUSED gpointer data)
+static void
+muttum_engine_new_thread (
+    GTask *task,
+    G_GNUC_UNUSED gpointer source_object,
+    gpointer task_data,
+    GCancellable *cancellable)
+{
+  if (g_task_return_error_if_cancelled(task)) {
+    return;
+  }
+
+  // Words are loaded by the first engine of their locale
+  GError *error = NULL;
+  MuttumEngine *engine = g_initable_new(MUTTUM_TYPE_ENGINE, cancellable, &error, "saved-game", task_data, NULL);
+
+  if (!engine) {
+    g_task_return_error(task, error);
+    return;
+  }
+
+  if (g_cancellable_is_cancelled(cancellable)) {
+    g_object_unref(engine);
+    g_task_return_error_if_cancelled(task);
+    return;
+  }
+
+  g_task_return_pointer(task, engine, g_object_unref);
+}
+
+/**
+ * muttum_engine_new_async:
+ * @cancellable: (nullable): optional #GCancellable object
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the engine is ready
+ * @user_data: (closure): the data to pass to callback function
+ *
+ * Creates a new engine in a worker thread. The first engine of a locale
+ * loads its dictionary, this function allows to do it without blocking the
+ * main loop.
+ */
+void muttum_engine_new_async (
+    GCancellable *cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+  muttum_engine_resume_async(NULL, cancellable, callback, user_data);
+}
+
+/**
+ * muttum_engine_resume_async:
+ * @saved_game: (nullable): game saved by muttum_engine_serialize()
+ * @cancellable: (nullable): optional #GCancellable object
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the engine is ready
+ * @user_data: (closure): the data to pass to callback function
+ *
+ * Like muttum_engine_new_async(), but the engine resumes @saved_game, see
+ * #MuttumEngine:saved-game. Call muttum_engine_new_finish() to get it.
+ */
+void muttum_engine_resume_async (
+    GBytes *saved_game,
+    GCancellable *cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+  g_autoptr(GTask) task = g_task_new(NULL, cancellable, callback, user_data);
+  g_task_set_source_tag(task, muttum_engine_new_async);
+  if (saved_game) {
+    g_task_set_task_data(task, g_bytes_ref(saved_game), (GDestroyNotify) g_bytes_unref);
+  }
+  g_task_run_in_thread(task, muttum_engine_new_thread);
+}
+
+/**
+ * muttum_engine_new_finish:
+ * @result: the #GAsyncResult given to the callback
+ * @error: return location for a #GError
+ *
+ * Returns: (transfer full) (nullable): the new engine or %NULL on error
+ */
+MuttumEngine *muttum_engine_new_finish (
+    GAsyncResult *result,
+    GError **error)
 {
-  return g_ptr_array_copy((GPtrArray *) src, muttum_engine_board_copy_letter, NULL);
+  g_return_val_if_fail(g_task_is_valid(result, NULL), NULL);
+  return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+/**
+ * muttum_engine_reset:
+ *
+ * Starts a new game with the same engine properties. The word, the board,
+ * the alphabet and the candidates of the previous game are reused, and the
+ * words of every length are prepared when the lexicon is loaded: a new game
+ * doesn't allocate memory. Only the first game of a thread allocates, to
+ * clone the ICU objects of the lexicon for it.
+ *
+ * No signal is emitted and the board length may change, views must read
+ * the whole board and alphabet again.
+ */
+void muttum_engine_reset(MuttumEngine *self) {
+  g_return_if_fail(MUTTUM_IS_ENGINE(self));
+  g_return_if_fail(self->lexicon != NULL);
+
+  muttum_engine_game_init(self);
+}
+
+/*
+ * Rows with a feedback: the current one too once the game is won.
+ */
+static guint muttum_engine_get_n_validated(guint current_row, MuttumEngineState state) {
+  return state == MUTTUM_ENGINE_STATE_WON ? current_row + 1 : current_row;
+}
+
+/*
+ * FNV-1a hash of the dictionary spelling of a word, saved games must not
+ * depend on the GLib version like g_str_hash() could.
+ */
+static guint32 muttum_engine_save_hash(const gchar *word) {
+  guint32 hash = 2166136261u;
+  for (const guchar *c = (const guchar *) word; *c; c += 1) {
+    hash = (hash ^ *c) * 16777619u;
+  }
+  return hash;
+}
+
+static gboolean muttum_engine_save_corrupted(GError **error) {
+  g_set_error_literal(
+      error, G_IO_ERROR,
+      G_IO_ERROR_INVALID_DATA,
+      _("The saved game is corrupted."));
+  return FALSE;
+}
+
+/*
+ * Resumes a game saved by muttum_engine_serialize(): the word is found back
+ * by its position, without picking a new one, and the validated rows are
+ * replayed. The game state is inconsistent on error, it must be
+ * initialized again.
+ */
+static gboolean muttum_engine_game_restore(MuttumEngine *self, GBytes *bytes, GError **error) {
+  gsize size = 0;
+  const MuttumEngineSave *save = g_bytes_get_data(bytes, &size);
+
+  if (size != sizeof(MuttumEngineSave) || memcmp(save->magic, MUTTUM_ENGINE_SAVE_MAGIC, sizeof(save->magic)) != 0) {
+    g_set_error_literal(
+        error, G_IO_ERROR,
+        G_IO_ERROR_INVALID_DATA,
+        _("This is not a saved game."));
+    return FALSE;
+  }
+
+  if (save->version != MUTTUM_ENGINE_SAVE_VERSION) {
+    g_set_error(
+        error, G_IO_ERROR,
+        G_IO_ERROR_NOT_SUPPORTED,
+        _("Saved games of version %u aren't supported."), save->version);
+    return FALSE;
+  }
+
+  // Such games can't be saved, see muttum_engine_serialize()
+  if (self->rows > MUTTUM_ENGINE_SAVE_ROWS) {
+    g_set_error(
+        error, G_IO_ERROR,
+        G_IO_ERROR_NOT_SUPPORTED,
+        _("Games of more than %u rows can't be resumed."), MUTTUM_ENGINE_SAVE_ROWS);
+    return FALSE;
+  }
+
+  MuttumEngineState state = save->state;
+  guint n_validated = muttum_engine_get_n_validated(save->current_row, state);
+  if (save->length < self->word_length_min || save->length > self->word_length_max
+      || state > MUTTUM_ENGINE_STATE_WON || n_validated > self->rows
+      || (state == MUTTUM_ENGINE_STATE_CONTINUE && save->current_row >= self->rows)
+      || (state == MUTTUM_ENGINE_STATE_LOST && save->current_row != self->rows)) {
+    return muttum_engine_save_corrupted(error);
+  }
+
+  // The word is looked up by its position, it must still be the same
+  MuttumDictionary *dictionary = muttum_lexicon_get_dictionary(self->lexicon);
+  guint word_index = GUINT32_FROM_LE(save->word_index);
+  if (word_index >= muttum_dictionary_get_n_playable(dictionary, save->length)) {
+    return muttum_engine_save_corrupted(error);
+  }
+
+  gchar buffer[MUTTUM_DICTIONARY_FOLDED_SIZE];
+  muttum_engine_word_set(self, muttum_dictionary_get_playable(dictionary, save->length, word_index, buffer));
+  if (muttum_engine_save_hash(self->dictionary_word->str) != GUINT32_FROM_LE(save->word_hash)) {
+    g_set_error_literal(
+        error, G_IO_ERROR,
+        G_IO_ERROR_INVALID_DATA,
+        _("The word of the saved game isn't in the dictionary anymore."));
+    return FALSE;
+  }
+
+  muttum_engine_alphabet_init(self);
+  muttum_engine_board_init(self);
+  if (self->length != save->length) {
+    return muttum_engine_save_corrupted(error);
+  }
+  muttum_engine_candidates_init(self);
+
+  // Feedback is computed again, the saved one only detects corrupted rows
+  guint64 word = muttum_score_pack_word(self->word->str, self->length);
+  for (guint row_index = 0; row_index < n_validated; row_index += 1) {
+    MuttumLetter *row = self->board + row_index * self->length;
+    const gchar *letters = save->letters[row_index];
+
+    for (guint col = 0; col < self->length; col += 1) {
+      if (letters[col] < 'a' || letters[col] > 'z' || (col == 0 && letters[col] != self->word->str[0])) {
+        return muttum_engine_save_corrupted(error);
+      }
+      row[col].letter = letters[col];
+    }
+
+    guint64 guess = muttum_score_pack_word(letters, self->length);
+    guint16 pattern = muttum_score_word(guess, word, self->length);
+    gboolean found = MUTTUM_SCORE_PATTERN_WELL_PLACED(pattern) == (1 << self->length) - 1;
+    gboolean last_won = state == MUTTUM_ENGINE_STATE_WON && row_index + 1 == n_validated;
+    if (pattern != GUINT16_FROM_LE(save->patterns[row_index]) || found != last_won) {
+      return muttum_engine_save_corrupted(error);
+    }
+
+    muttum_engine_row_apply(self, row, guess, pattern);
+    if (!found && row_index + 1 < self->rows) {
+      self->board[(row_index + 1) * self->length].letter = self->word->str[0];
+    }
+  }
+
+  // Letters typed on the current row, after the given one
+  if (state == MUTTUM_ENGINE_STATE_CONTINUE) {
+    MuttumLetter *row = self->board + save->current_row * self->length;
+    const gchar *letters = save->letters[save->current_row];
+
+    for (guint col = 1; col < self->length; col += 1) {
+      if (letters[col] != MUTTUM_ENGINE_NULL_LETTER && (letters[col] < 'a' || letters[col] > 'z')) {
+        return muttum_engine_save_corrupted(error);
+      }
+      row[col].letter = letters[col];
+    }
+  }
+
+  self->word_index = word_index;
+  self->current_row = save->current_row;
+  self->state = state;
+
+  return TRUE;
+}
+
+/**
+ * muttum_engine_serialize:
+ *
+ * Saves the game in a fixed layout of 76 bytes: the position of the word
+ * in the dictionary, the letters of the rows and their feedback. Engine
+ * properties aren't saved, the game must be resumed by an engine of the
+ * same locale, word list and geometry, see muttum_engine_deserialize() and
+ * #MuttumEngine:saved-game.
+ *
+ * Returns: (transfer full) (nullable): the saved game, or %NULL if the
+ * board has more than 6 rows
+ */
+GBytes *muttum_engine_serialize(MuttumEngine *self) {
+  g_return_val_if_fail(MUTTUM_IS_ENGINE(self), NULL);
+  g_return_val_if_fail(self->lexicon != NULL, NULL);
+
+  if (self->rows > MUTTUM_ENGINE_SAVE_ROWS) {
+    return NULL;
+  }
+
+  MuttumEngineSave *save = g_new0(MuttumEngineSave, 1);
+  memcpy(save->magic, MUTTUM_ENGINE_SAVE_MAGIC, sizeof(save->magic));
+  save->version = MUTTUM_ENGINE_SAVE_VERSION;
+  save->length = self->length;
+  save->current_row = self->current_row;
+  save->state = self->state;
+  save->word_index = GUINT32_TO_LE(self->word_index);
+  save->word_hash = GUINT32_TO_LE(muttum_engine_save_hash(self->dictionary_word->str));
+
+  guint64 word = muttum_score_pack_word(self->word->str, self->length);
+  guint n_validated = muttum_engine_get_n_validated(self->current_row, self->state);
+  guint n_rows = MIN(self->current_row + 1, self->rows);
+
+  for (guint row_index = 0; row_index < n_rows; row_index += 1) {
+    const MuttumLetter *row = self->board + row_index * self->length;
+    for (guint col = 0; col < self->length; col += 1) {
+      save->letters[row_index][col] = row[col].letter;
+    }
+
+    if (row_index < n_validated) {
+      guint64 guess = muttum_score_pack_word(save->letters[row_index], self->length);
+      save->patterns[row_index] = GUINT16_TO_LE(muttum_score_word(guess, word, self->length));
+    }
+  }
+
+  return g_bytes_new_take(save, sizeof(*save));
+}
+
+/**
+ * muttum_engine_deserialize:
+ * @bytes: game saved by muttum_engine_serialize()
+ * @error: return location for a #GError
+ *
+ * Creates an engine with the default properties resuming the game of
+ * @bytes. The word isn't picked again, it is looked up by its position in
+ * the dictionary.
+ *
+ * Returns: (transfer full) (nullable): the new engine, or %NULL if @bytes
+ * isn't a valid game of the default word list or if the words couldn't be
+ * loaded
+ */
+MuttumEngine *muttum_engine_deserialize(GBytes *bytes, GError **error) {
+  g_return_val_if_fail(bytes != NULL, NULL);
+  g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+  MuttumEngine *engine = g_initable_new(MUTTUM_TYPE_ENGINE, NULL, error, "saved-game", bytes, NULL);
+
+  if (!engine) {
+    return NULL;
+  }
+
+  if (engine->restore_error) {
+    g_propagate_error(error, g_steal_pointer(&engine->restore_error));
+    g_object_unref(engine);
+    return NULL;
+  }
+
+  return engine;
 }
 
 /**
  * muttum_engine_get_board_state:
  *
+ * Copies the board, use muttum_engine_peek_board() to read it on each frame.
+ *
  * Returns: (element-type GPtrArray(MuttumLetter)) (transfer full): the current game board state inside a matrix of GPtrArray
  * (rows and columns) of MuttumLetter
  */
 GPtrArray* muttum_engine_get_board_state(MuttumEngine* self) {
   g_return_val_if_fail(MUTTUM_IS_ENGINE(self), NULL);
+  g_return_val_if_fail(self->lexicon != NULL, NULL);
 
-  return g_ptr_array_copy(self->board, muttum_engine_board_copy_row, NULL);
+  GPtrArray *board = g_ptr_array_new_full(self->rows, (GDestroyNotify) g_ptr_array_unref);
+  for (guint row_index = 0; row_index < self->rows; row_index += 1) {
+    GPtrArray *row = g_ptr_array_new_full(self->length, g_free);
+    for (guint col = 0; col < self->length; col += 1) {
+      g_ptr_array_add(row, muttum_engine_board_copy_letter(&self->board[row_index * self->length + col], NULL));
+    }
+    g_ptr_array_add(board, row);
+  }
+
+  return board;
+}
+
+/**
+ * muttum_engine_peek_board:
+ * @n_rows: (out) (optional): return location for the number of rows
+ * @length: (out) (optional): return location for the number of letters by row
+ *
+ * Gives a read only access to the board without copying it, letter at
+ * column c of row r is at index r * @length + c. The board is updated in
+ * place by the game actions and stays valid as long as the engine.
+ *
+ * Returns: (transfer none) (array): the board letters, row after row
+ */
+const MuttumLetter *muttum_engine_peek_board(MuttumEngine *self, guint *n_rows, guint *length) {
+  g_return_val_if_fail(MUTTUM_IS_ENGINE(self), NULL);
+  g_return_val_if_fail(self->lexicon != NULL, NULL);
+
+  if (n_rows) {
+    *n_rows = self->rows;
+  }
+  if (length) {
+    *length = self->length;
+  }
+
+  return self->board;
 }
 
 /**
@@ -424,27 +1210,47 @@ GPtrArray* muttum_engine_get_board_state(MuttumEngine* self) {
 GPtrArray* muttum_engine_get_alphabet_state (MuttumEngine *self) {
   g_return_val_if_fail(MUTTUM_IS_ENGINE(self), NULL);
 
-  return g_ptr_array_copy(self->alphabet, muttum_engine_board_copy_letter, NULL);
+  GPtrArray *alphabet = g_ptr_array_new_full(G_N_ELEMENTS(self->alphabet), g_free);
+  for (guint i = 0; i < G_N_ELEMENTS(self->alphabet); i += 1) {
+    g_ptr_array_add(alphabet, muttum_engine_board_copy_letter(&self->alphabet[i], NULL));
+  }
+
+  return alphabet;
+}
+
+/**
+ * muttum_engine_get_letter_state:
+ * @letter: a letter from 'a' to 'z'
+ *
+ * Returns: the state of @letter in the alphabet
+ */
+MuttumLetterState muttum_engine_get_letter_state (MuttumEngine *self, gchar letter) {
+  g_return_val_if_fail(MUTTUM_IS_ENGINE(self), MUTTUM_LETTER_UNKOWN);
+  g_return_val_if_fail(letter >= 'a' && letter <= 'z', MUTTUM_LETTER_UNKOWN);
+
+  return self->alphabet[letter - 'a'].state;
 }
 
 /**
  * muttum_engine_add_letter:
- * @letter: A letter to add. The letter must be available in the alphabet.
+ * @letter: A letter to add, from 'a' to 'z'.
  *
  * Action to call when player wants to add a new letter on the current row.
  */
 void muttum_engine_add_letter (MuttumEngine *self, const char letter)
 {
   g_return_if_fail(MUTTUM_IS_ENGINE(self));
+  g_return_if_fail(self->lexicon != NULL);
+  g_return_if_fail(letter >= 'a' && letter <= 'z');
 
-  if (self->current_row >= MUTTUM_ENGINE_ROWS || self->state != MUTTUM_ENGINE_STATE_CONTINUE) {
+  if (self->current_row >= self->rows || self->state != MUTTUM_ENGINE_STATE_CONTINUE) {
     return;
   }
 
-  GPtrArray* row = g_ptr_array_index(self->board, self->current_row);
+  MuttumLetter *row = self->board + self->current_row * self->length;
 
-  for (guint col = 0; col < row->len; col += 1) {
-    MuttumLetter *rowLetter = g_ptr_array_index(row, col);
+  for (guint col = 0; col < self->length; col += 1) {
+    MuttumLetter *rowLetter = &row[col];
     if (rowLetter->letter == MUTTUM_ENGINE_NULL_LETTER) {
       // Ignore input if player write the first letter on second position
       if (col == 1 && letter == self->word->str[0]) {
@@ -452,6 +1258,7 @@ void muttum_engine_add_letter (MuttumEngine *self, const char letter)
       }
       rowLetter->letter = letter;
       rowLetter->state = MUTTUM_LETTER_UNKOWN;
+      g_signal_emit(self, signals[SIGNAL_CELL_CHANGED], 0, self->current_row, col);
       break;
     }
   }
@@ -465,62 +1272,100 @@ void muttum_engine_add_letter (MuttumEngine *self, const char letter)
 void muttum_engine_remove_letter (MuttumEngine *self)
 {
   g_return_if_fail(MUTTUM_IS_ENGINE(self));
+  g_return_if_fail(self->lexicon != NULL);
 
-  if (self->current_row >= MUTTUM_ENGINE_ROWS  || self->state != MUTTUM_ENGINE_STATE_CONTINUE) {
+  if (self->current_row >= self->rows  || self->state != MUTTUM_ENGINE_STATE_CONTINUE) {
     return;
   }
 
-  GPtrArray* row = g_ptr_array_index(self->board, self->current_row);
+  MuttumLetter *row = self->board + self->current_row * self->length;
 
-  for (guint col = row->len - 1; col <= row->len; col -= 1) {
-    MuttumLetter *letter = g_ptr_array_index(row, col);
+  for (guint col = self->length - 1; col <= self->length; col -= 1) {
+    MuttumLetter *letter = &row[col];
     if (letter->letter != MUTTUM_ENGINE_NULL_LETTER && col != 0) {
       letter->letter = MUTTUM_ENGINE_NULL_LETTER;
       letter->state = MUTTUM_LETTER_UNKOWN;
+      g_signal_emit(self, signals[SIGNAL_CELL_CHANGED], 0, self->current_row, col);
       break;
     }
   }
 }
 
-static gboolean
-muttum_engine_compare_letter_private_with_letter (
-    gconstpointer letter_private,
-    gconstpointer letter
-) {
-  const MuttumLetterPrivate *first = letter_private;
-  const MuttumLetter *second = letter;
-  return first->letter == second->letter;
-}
-
-/**
- * muttum_engine_validate:
- *
- * Action to call when a player wants to validate the word on the current row.
+/*
+ * Sets the states of the letters of @row and of the alphabet from the
+ * @pattern of @guess, and narrows the candidates of the previous rows.
  *
- * This function can return `MuttumEngineError` if the word was invalid.
- *
- * If the word was valid, it updates states of the game, alphabet and board.
+ * Returns: bit l is set if the alphabet state of letter 'a' + l changed
  */
-void muttum_engine_validate(MuttumEngine *self, GError **error) {
-  g_return_if_fail(MUTTUM_IS_ENGINE(self));
-  g_return_if_fail (error == NULL || *error == NULL);
+static guint32 muttum_engine_row_apply(MuttumEngine *self, MuttumLetter *row, guint64 guess, guint16 pattern) {
+  guint8 well_placed = MUTTUM_SCORE_PATTERN_WELL_PLACED(pattern);
+  guint8 present = MUTTUM_SCORE_PATTERN_PRESENT(pattern);
+
+  guint32 alphabet_changes = 0;
+
+  for (guint col = 0; col < self->length; col += 1) {
+    MuttumLetter *letter = &row[col];
+    MuttumLetterPrivate *alphabet = NULL;
+
+    // Alphabet is sorted from a to z
+    if (letter->letter >= 'a' && letter->letter <= 'z') {
+      alphabet = &self->alphabet[letter->letter - 'a'];
+    }
+
+    if (well_placed & (1 << col)) {
+      letter->state = MUTTUM_LETTER_WELL_PLACED;
+    } else if (present & (1 << col)) {
+      letter->state = MUTTUM_LETTER_PRESENT;
+    } else {
+      letter->state = MUTTUM_LETTER_NOT_PRESENT;
+    }
+
+    if (!alphabet) {
+      continue;
+    }
+
+    MuttumLetterState previous_state = alphabet->state;
+    if (letter->state == MUTTUM_LETTER_WELL_PLACED) {
+      alphabet->state = MUTTUM_LETTER_WELL_PLACED;
+    } else if (letter->state == MUTTUM_LETTER_PRESENT && alphabet->state != MUTTUM_LETTER_WELL_PLACED) {
+      alphabet->state = MUTTUM_LETTER_PRESENT;
+    } else if (alphabet->state == MUTTUM_LETTER_UNKOWN) {
+      alphabet->state = MUTTUM_LETTER_NOT_PRESENT;
+    }
 
-  MuttumEngineClass* klass = MUTTUM_ENGINE_GET_CLASS(self);
+    if (alphabet->state != previous_state) {
+      alphabet_changes |= 1 << (letter->letter - 'a');
+    }
+  }
 
-  GPtrArray *row = g_ptr_array_index(self->board, self->current_row);
-  GString *word = g_string_new(NULL);
+  // Narrows the candidates of the previous row with this one only
+  if (self->candidates) {
+    gint64 start_time = g_get_monotonic_time();
+    guint count = muttum_solver_candidates_filter(self->candidates, guess, pattern);
+    g_debug("MuttumEngine: %u candidates left, narrowed in %" G_GINT64_FORMAT " µs",
+        count, g_get_monotonic_time() - start_time);
+  }
 
-  if (self->current_row >= MUTTUM_ENGINE_ROWS  || self->state != MUTTUM_ENGINE_STATE_CONTINUE) {
+  return alphabet_changes;
+}
+
+/*
+ * Validates the current row, see muttum_engine_validate().
+ */
+static void muttum_engine_validate_row(MuttumEngine *self, GError **error) {
+  if (self->current_row >= self->rows  || self->state != MUTTUM_ENGINE_STATE_CONTINUE) {
     return;
   }
 
+  MuttumLetter *row = self->board + self->current_row * self->length;
+  gchar word[MUTTUM_DICTIONARY_FOLDED_SIZE];
+
   // Ensure all letters were given
-  for (guint col = 0; col < row->len; col += 1) {
-    MuttumLetter *letter = g_ptr_array_index(row, col);
-    g_string_append_c(word, letter->letter);
+  for (guint col = 0; col < self->length; col += 1) {
+    MuttumLetter *letter = &row[col];
+    word[col] = letter->letter;
 
     if (letter->letter == MUTTUM_ENGINE_NULL_LETTER) {
-      g_string_free(word, TRUE);
       g_set_error_literal(
           error, MUTTUM_ENGINE_ERROR,
           MUTTUM_ENGINE_ERROR_LINE_INCOMPLETE,
@@ -528,30 +1373,31 @@ void muttum_engine_validate(MuttumEngine *self, GError **error) {
       return;
     }
   }
+  word[self->length] = '\0';
 
-  // Check if the given word exists in dictionary
+  // Check if the given word exists in dictionary, typed a-z letters are
+  // looked up by their fold key without calling ICU
+  MuttumDictionary *dictionary = muttum_lexicon_get_dictionary(self->lexicon);
+  guint64 fold_key = muttum_fold_pack(word, self->length);
+  gboolean word_exists = FALSE;
 
-  // Compute u_word collapse key
-  UChar u_word_buffer[MUTTUM_ENGINE_UCHAR_BUFFER_SIZE];
-  unsigned char key_buffer[MUTTUM_ENGINE_UCHAR_BUFFER_SIZE];
-  unsigned char* current_key_buffer = key_buffer;
-  uint32_t key_buffer_size = sizeof(key_buffer);
-  uint32_t key_buffer_expected_size = 0;
-
-  u_uastrcpy(u_word_buffer, word->str);
-  key_buffer_expected_size = ucol_getSortKey(klass->collator, u_word_buffer, -1, key_buffer, key_buffer_size);
-
-  if (key_buffer_expected_size > key_buffer_size) {
-    current_key_buffer = g_new(unsigned char, key_buffer_expected_size);
-    key_buffer_size = ucol_getSortKey(klass->collator, u_word_buffer, -1, current_key_buffer, key_buffer_expected_size);
-  }
-
-  gboolean word_exists = g_tree_lookup(klass->dictionary, current_key_buffer) != NULL;
+  if (fold_key != MUTTUM_FOLD_KEY_NONE) {
+    word_exists = muttum_dictionary_contains_folded(dictionary, fold_key);
+  } else {
+    // Compute u_word collapse key
+    unsigned char key_buffer[MUTTUM_ENGINE_UCHAR_BUFFER_SIZE];
+    unsigned char* current_key_buffer = muttum_dictionary_compute_key(
+        muttum_lexicon_get_collator(self->lexicon), word, key_buffer, sizeof(key_buffer), NULL);
+
+    // Words without a collation key aren't in the dictionary
+    if (current_key_buffer) {
+      word_exists = muttum_dictionary_contains(dictionary, current_key_buffer, self->length);
+    }
 
-  if (current_key_buffer != key_buffer) {
-    g_free(current_key_buffer);
+    if (current_key_buffer != key_buffer) {
+      g_free(current_key_buffer);
+    }
   }
-  g_string_free(word, TRUE);
 
   if(!word_exists) {
     g_set_error_literal(
@@ -561,83 +1407,78 @@ void muttum_engine_validate(MuttumEngine *self, GError **error) {
     return;
   }
 
-  // Reset alphabet found
-  for (guint i = 0; i < self->alphabet->len; i += 1) {
-    MuttumLetterPrivate *alphabet = g_ptr_array_index(self->alphabet, i);
-    alphabet->found = 0;
+  // Validate state for each letter on current row, with the same kernel
+  // as analysis tools
+  gchar letters[MUTTUM_SCORE_WORD_LENGTH_MAX];
+  for (guint col = 0; col < self->length; col += 1) {
+    letters[col] = row[col].letter;
   }
+  guint64 guess = muttum_score_pack_word(letters, self->length);
+  guint16 pattern = muttum_score_word(guess, muttum_score_pack_word(self->word->str, self->length), self->length);
+  guint32 alphabet_changes = muttum_engine_row_apply(self, row, guess, pattern);
 
-  // Validate state for each letter on current row
+  guint validated_row = self->current_row;
 
-  // First pass find all well placed letters
-  guint well_placed = 0;
-  for (guint col = 0; col < row->len; col += 1) {
-    MuttumLetter *letter = g_ptr_array_index(row, col);
+  if (MUTTUM_SCORE_PATTERN_WELL_PLACED(pattern) == (1 << self->length) - 1) {
+    self->state = MUTTUM_ENGINE_STATE_WON;
+  } else {
+    // Move to next row
+    self->current_row++;
 
-    // Alphabet is used to store found letter count
-    guint* alphabet_index = g_new(guint, 1);
-    MuttumLetterPrivate *alphabet = NULL;
-    if (g_ptr_array_find_with_equal_func(self->alphabet, letter,
-          muttum_engine_compare_letter_private_with_letter,
-          alphabet_index)) {
-      alphabet = g_ptr_array_index(self->alphabet, *alphabet_index);
+    if (self->current_row < self->rows) {
+      self->board[self->current_row * self->length].letter = self->word->str[0];
+    } else {
+      // Cannot play anymore game is lost
+      self->state = MUTTUM_ENGINE_STATE_LOST;
     }
-    g_return_if_fail(alphabet);
+  }
 
-    if (self->word->str[col] == letter->letter) {
-      letter->state = MUTTUM_LETTER_WELL_PLACED;
-      alphabet->state = MUTTUM_LETTER_WELL_PLACED;
-      alphabet->found++;
-      well_placed++;
+  // Signals are emitted once the whole game state is updated
+  for (guint letter = 0; letter < 26; letter += 1) {
+    if (alphabet_changes & (1 << letter)) {
+      g_signal_emit(self, signals[SIGNAL_ALPHABET_CHANGED], 0, (gchar) ('a' + letter));
     }
   }
-
-  if (well_placed == row->len) {
-    self->state = MUTTUM_ENGINE_STATE_WON;
-    return;
+  if (self->current_row != validated_row && self->current_row < self->rows) {
+    g_signal_emit(self, signals[SIGNAL_CELL_CHANGED], 0, self->current_row, 0);
   }
+  g_signal_emit(self, signals[SIGNAL_ROW_VALIDATED], 0, validated_row);
+}
 
-  // Second pass find all letters present but not well placed
-  for (guint col = 0; col < row->len; col += 1) {
-    MuttumLetter *letter = g_ptr_array_index(row, col);
+/**
+ * muttum_engine_validate:
+ *
+ * Action to call when a player wants to validate the word on the current row.
+ *
+ * This function can return `MuttumEngineError` if the word was invalid.
+ *
+ * If the word was valid, it updates states of the game, alphabet and board.
+ */
+void muttum_engine_validate(MuttumEngine *self, GError **error) {
+  g_return_if_fail(MUTTUM_IS_ENGINE(self));
+  g_return_if_fail(self->lexicon != NULL);
+  g_return_if_fail (error == NULL || *error == NULL);
 
-    // Alphabet is used to store found letter count
-    guint* alphabet_index = g_new(guint, 1);
-    MuttumLetterPrivate *alphabet = NULL;
-    if (g_ptr_array_find_with_equal_func(self->alphabet, letter,
-          muttum_engine_compare_letter_private_with_letter,
-          alphabet_index)) {
-      alphabet = g_ptr_array_index(self->alphabet, *alphabet_index);
-    }
-    g_return_if_fail(alphabet);
-
-    if (self->word->str[col] != letter->letter) {
-      if (alphabet->found < alphabet->position->len) {
-        letter->state = MUTTUM_LETTER_PRESENT;
-        if (alphabet->state != MUTTUM_LETTER_WELL_PLACED) {
-          alphabet->state = MUTTUM_LETTER_PRESENT;
-        }
-        alphabet->found++;
-      } else {
-        letter->state = MUTTUM_LETTER_NOT_PRESENT;
-        if (alphabet->state == MUTTUM_LETTER_UNKOWN) {
-          alphabet->state = MUTTUM_LETTER_NOT_PRESENT;
-        }
-      }
-    }
-  }
+  gint64 start_time = g_get_monotonic_time();
+  gint64 trace_time = MUTTUM_TRACE_BEGIN();
+  guint row = self->current_row;
 
-  // Move to next row
-  self->current_row++;
+  muttum_engine_validate_row(self, error);
 
-  if (self->current_row < MUTTUM_ENGINE_ROWS) {
-    GPtrArray* nextRow = g_ptr_array_index(self->board, self->current_row);
-    MuttumLetter* firstLetter = g_ptr_array_index(nextRow, 0);
-    firstLetter->letter = self->word->str[0];
-  } else {
-    // Cannot play anymore game is lost
-    self->state = MUTTUM_ENGINE_STATE_LOST;
+  // Bucket i holds durations from 2^(i-1) to 2^i µs
+  gint64 duration = g_get_monotonic_time() - start_time;
+  guint bucket = 0;
+  while (bucket + 1 < MUTTUM_ENGINE_STATS_LATENCY_BUCKETS && duration >= G_GINT64_CONSTANT(1) << bucket) {
+    bucket += 1;
   }
+  self->stats.n_validations += 1;
+  self->stats.validation_latency[bucket] += 1;
+
+  MuttumEngineThreadStats *thread_stats = muttum_engine_get_thread_stats();
+  muttum_engine_counter_add(&thread_stats->n_validations, 1);
+  muttum_engine_counter_add(&thread_stats->validation_latency[bucket], 1);
+
+  MUTTUM_TRACE_END(trace_time, "validate", "row %u", row);
 }
 
 /**
@@ -667,5 +1508,157 @@ MuttumEngineState muttum_engine_get_game_state(MuttumEngine *self) {
  */
 GString *muttum_engine_get_word(MuttumEngine *self) {
   g_return_val_if_fail(MUTTUM_IS_ENGINE(self), NULL);
+  g_return_val_if_fail(self->lexicon != NULL, NULL);
   return g_string_new(self->dictionary_word->str);
 }
+
+/**
+ * muttum_engine_get_candidate_count:
+ *
+ * Words are compared without accents, so several dictionary words may count
+ * as one candidate.
+ *
+ * Returns: the number of words still consistent with every validated row
+ */
+guint muttum_engine_get_candidate_count(MuttumEngine *self) {
+  g_return_val_if_fail(MUTTUM_IS_ENGINE(self), 0);
+
+  if (!self->candidates) {
+    return 0;
+  }
+
+  return muttum_solver_candidates_get_count(self->candidates);
+}
+
+/**
+ * muttum_engine_candidate_iter_init:
+ * @iter: an uninitialized #MuttumEngineCandidateIter
+ *
+ * Initializes @iter to walk the words still consistent with every validated
+ * row, in alphabetical order. The iterator is invalidated by the next
+ * muttum_engine_validate() or muttum_engine_reset().
+ */
+void muttum_engine_candidate_iter_init(MuttumEngineCandidateIter *iter, MuttumEngine *self) {
+  g_return_if_fail(iter != NULL);
+  g_return_if_fail(MUTTUM_IS_ENGINE(self));
+
+  MuttumEngineRealCandidateIter *real_iter = (MuttumEngineRealCandidateIter *) iter;
+  real_iter->candidates = self->candidates;
+  real_iter->position = -1;
+}
+
+/**
+ * muttum_engine_candidate_iter_next:
+ * @iter: a #MuttumEngineCandidateIter
+ * @word: (out) (transfer none) (optional): the next candidate, without
+ *   accents, valid until the next call
+ *
+ * Returns: %FALSE if the end of the candidates has been reached
+ */
+gboolean muttum_engine_candidate_iter_next(MuttumEngineCandidateIter *iter, const gchar **word) {
+  g_return_val_if_fail(iter != NULL, FALSE);
+
+  MuttumEngineRealCandidateIter *real_iter = (MuttumEngineRealCandidateIter *) iter;
+
+  if (!real_iter->candidates) {
+    return FALSE;
+  }
+
+  real_iter->position = muttum_solver_candidates_next(real_iter->candidates, real_iter->position);
+  if (real_iter->position < 0) {
+    return FALSE;
+  }
+
+  if (word) {
+    MuttumSolverLexicon *lexicon = muttum_solver_candidates_get_lexicon(real_iter->candidates);
+    guint length = muttum_solver_lexicon_get_length(lexicon);
+    memcpy(real_iter->word, muttum_solver_lexicon_get_word(lexicon, real_iter->position), length);
+    real_iter->word[length] = '\0';
+    *word = real_iter->word;
+  }
+
+  return TRUE;
+}
+
+/**
+ * muttum_engine_suggest_guess:
+ *
+ * Finds the word giving the most expected information about the word to
+ * find, among the words consistent with the validated rows of the board.
+ *
+ * Returns: (transfer full) (nullable): the word to type, or %NULL if the
+ * game is over or no word is consistent with the board
+ */
+gchar *muttum_engine_suggest_guess(MuttumEngine *self) {
+  g_return_val_if_fail(MUTTUM_IS_ENGINE(self), NULL);
+  g_return_val_if_fail(self->lexicon != NULL, NULL);
+
+  if (self->state != MUTTUM_ENGINE_STATE_CONTINUE || !self->candidates) {
+    return NULL;
+  }
+
+  gint64 position = muttum_solver_suggest(self->candidates);
+  if (position < 0) {
+    return NULL;
+  }
+
+  MuttumSolverLexicon *lexicon = muttum_solver_candidates_get_lexicon(self->candidates);
+  return g_strndup(muttum_solver_lexicon_get_word(lexicon, position), muttum_solver_lexicon_get_length(lexicon));
+}
+
+/*
+ * Copies the dictionary fields of @lexicon stats into @stats.
+ */
+static void muttum_engine_stats_set_lexicon(MuttumEngineStats *stats, MuttumLexicon *lexicon) {
+  MuttumLexiconStats lexicon_stats;
+  muttum_lexicon_get_stats(lexicon, &lexicon_stats);
+
+  stats->dictionary_load_time = lexicon_stats.load_time;
+  stats->n_collapsed = lexicon_stats.n_collapsed;
+  memset(stats->n_words, 0, sizeof(stats->n_words));
+  memcpy(stats->n_words, lexicon_stats.n_words, sizeof(lexicon_stats.n_words));
+}
+
+/**
+ * muttum_engine_get_stats:
+ * @stats: (out caller-allocates): the statistics of the engine
+ *
+ * Fills @stats with the validations and word selections of this engine,
+ * and the load statistics of its dictionary.
+ */
+void muttum_engine_get_stats(MuttumEngine *self, MuttumEngineStats *stats) {
+  g_return_if_fail(stats != NULL);
+  memset(stats, 0, sizeof(*stats));
+  g_return_if_fail(MUTTUM_IS_ENGINE(self));
+  g_return_if_fail(self->lexicon != NULL);
+
+  *stats = self->stats;
+  muttum_engine_stats_set_lexicon(stats, self->lexicon);
+}
+
+/**
+ * muttum_engine_get_class_stats:
+ * @stats: (out caller-allocates): the statistics of every engine
+ *
+ * Like muttum_engine_get_stats(), but for every engine of the process,
+ * finalized ones included. Dictionary fields sum every dictionary loaded.
+ */
+void muttum_engine_get_class_stats(MuttumEngineStats *stats) {
+  g_return_if_fail(stats != NULL);
+
+  // Counters are summed here, engines only count in their thread
+  MuttumEngineThreadStats sum;
+  g_mutex_lock(&muttum_engine_class_stats_mutex);
+  sum = muttum_engine_exited_stats;
+  for (GSList *l = muttum_engine_thread_stats; l; l = l->next) {
+    muttum_engine_thread_stats_sum(&sum, l->data);
+  }
+  g_mutex_unlock(&muttum_engine_class_stats_mutex);
+
+  memset(stats, 0, sizeof(*stats));
+  stats->n_validations = sum.n_validations;
+  memcpy(stats->validation_latency, sum.validation_latency, sizeof(sum.validation_latency));
+  stats->n_word_selections = sum.n_word_selections;
+  stats->word_selection_time = sum.word_selection_time;
+  muttum_engine_stats_set_lexicon(stats, NULL);
+}
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <gio/gio.h>
 #include <glib-object.h>
 #include <glib-2.0/glib.h>
 
@@ -50,6 +51,23 @@ typedef enum {
   MUTTUM_ENGINE_STATE_WON,
 } MuttumEngineState;
 
+/**
+ * MuttumEngineLengthDistribution:
+ * @MUTTUM_ENGINE_LENGTH_DISTRIBUTION_UNIFORM: every word length with playable
+ *   words is equally likely
+ * @MUTTUM_ENGINE_LENGTH_DISTRIBUTION_DICTIONARY: every playable word is equally
+ *   likely, word lengths follow the dictionary distribution
+ *
+ * How the length of the word to find is chosen
+ */
+typedef enum {
+  MUTTUM_ENGINE_LENGTH_DISTRIBUTION_UNIFORM,
+  MUTTUM_ENGINE_LENGTH_DISTRIBUTION_DICTIONARY,
+} MuttumEngineLengthDistribution;
+
+#define MUTTUM_TYPE_ENGINE_LENGTH_DISTRIBUTION muttum_engine_length_distribution_get_type ()
+GType muttum_engine_length_distribution_get_type (void);
+
 /**
  * MuttumLetter:
  *
@@ -60,6 +78,81 @@ typedef struct {
   MuttumLetterState state;
 } MuttumLetter;
 
+/**
+ * MuttumEngineCandidateIter:
+ *
+ * Iterator over the words still consistent with the validated rows, see
+ * muttum_engine_candidate_iter_init(). Its fields are private.
+ */
+typedef struct {
+  /*< private >*/
+  gpointer dummy1;
+  gint64 dummy2;
+  gchar dummy3[16];
+} MuttumEngineCandidateIter;
+
+/**
+ * MUTTUM_ENGINE_ROWS_MAX:
+ *
+ * Most rows of a board, see #MuttumEngine:rows.
+ */
+#define MUTTUM_ENGINE_ROWS_MAX 12
+
+/**
+ * MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MIN:
+ *
+ * Shortest word length of #MuttumEngine:word-length-min.
+ */
+#define MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MIN 4
+
+/**
+ * MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MAX:
+ *
+ * Longest word length of #MuttumEngine:word-length-max, feedback patterns
+ * hold 8 letters.
+ */
+#define MUTTUM_ENGINE_WORD_LENGTH_LIMIT_MAX 8
+
+/**
+ * MUTTUM_ENGINE_STATS_LENGTH_MAX:
+ *
+ * Longest word length counted by #MuttumEngineStats.
+ */
+#define MUTTUM_ENGINE_STATS_LENGTH_MAX 16
+
+/**
+ * MUTTUM_ENGINE_STATS_LATENCY_BUCKETS:
+ *
+ * Number of buckets of the validation latency histogram.
+ */
+#define MUTTUM_ENGINE_STATS_LATENCY_BUCKETS 16
+
+/**
+ * MuttumEngineStats:
+ * @dictionary_load_time: time spent loading the dictionary, in microseconds
+ * @n_words: number of playable words indexed by word length
+ * @n_collapsed: words of the word list dropped because they had the same
+ *   collation key as another word
+ * @n_validations: number of calls to muttum_engine_validate()
+ * @validation_latency: validations by duration: bucket 0 counts the ones
+ *   under 1 µs, bucket i the ones from 2^(i-1) to 2^i µs and the last
+ *   bucket every longer one
+ * @n_word_selections: number of words picked for new games
+ * @word_selection_time: time spent picking words, in microseconds
+ *
+ * Counters filled by muttum_engine_get_stats() and
+ * muttum_engine_get_class_stats().
+ */
+typedef struct {
+  gint64 dictionary_load_time;
+  guint n_words[MUTTUM_ENGINE_STATS_LENGTH_MAX + 1];
+  guint n_collapsed;
+  guint64 n_validations;
+  guint64 validation_latency[MUTTUM_ENGINE_STATS_LATENCY_BUCKETS];
+  guint64 n_word_selections;
+  gint64 word_selection_time;
+} MuttumEngineStats;
+
 /**
  * MuttumEngineError:
  *
@@ -74,6 +167,9 @@ typedef enum {
 
 /*
  * Type declaration.
+ *
+ * MuttumEngine is a #GInitable, its words are loaded by g_initable_init():
+ * create engines with g_initable_new() or muttum_engine_new_async().
  * */
 
 #define MUTTUM_TYPE_ENGINE muttum_engine_get_type ()
@@ -128,10 +224,33 @@ G_GNUC_END_IGNORE_DEPRECATIONS
  * Public method definitions.
  * */
 
+void muttum_engine_new_async (GCancellable *cancellable,
+                              GAsyncReadyCallback callback,
+                              gpointer user_data);
+
+void muttum_engine_resume_async (GBytes *saved_game,
+                                 GCancellable *cancellable,
+                                 GAsyncReadyCallback callback,
+                                 gpointer user_data);
+
+MuttumEngine *muttum_engine_new_finish (GAsyncResult *result,
+                                        GError **error);
+
+GBytes *muttum_engine_serialize (MuttumEngine *self);
+
+MuttumEngine *muttum_engine_deserialize (GBytes *bytes,
+                                         GError **error);
+
+void muttum_engine_reset (MuttumEngine *self);
+
 GPtrArray* muttum_engine_get_board_state (MuttumEngine *self);
 
+const MuttumLetter *muttum_engine_peek_board (MuttumEngine *self, guint *n_rows, guint *length);
+
 GPtrArray* muttum_engine_get_alphabet_state (MuttumEngine *self);
 
+MuttumLetterState muttum_engine_get_letter_state (MuttumEngine *self, gchar letter);
+
 void muttum_engine_add_letter (MuttumEngine *self, const char letter);
 
 void muttum_engine_remove_letter (MuttumEngine *self);
@@ -143,4 +262,16 @@ guint muttum_engine_get_current_row (MuttumEngine *self);
 
 GString *muttum_engine_get_word(MuttumEngine *self);
 
+guint muttum_engine_get_candidate_count(MuttumEngine *self);
+
+void muttum_engine_candidate_iter_init(MuttumEngineCandidateIter *iter, MuttumEngine *self);
+
+gboolean muttum_engine_candidate_iter_next(MuttumEngineCandidateIter *iter, const gchar **word);
+
+gchar *muttum_engine_suggest_guess(MuttumEngine *self);
+
+void muttum_engine_get_stats (MuttumEngine *self, MuttumEngineStats *stats);
+
+void muttum_engine_get_class_stats (MuttumEngineStats *stats);
+
 G_END_DECLS
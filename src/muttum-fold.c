@@ -0,0 +1,258 @@
+/* muttum-fold.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "muttum-fold.h"
+
+#define MUTTUM_FOLD_TABLE_SIZE 0x180
+#define MUTTUM_FOLD_LETTER_BITS 5
+
+/*
+ * Result of the "NFD; [:Nonspacing Mark:] Remove; Lower; NFC"
+ * transliterator for each character, 0 when it isn't a single ASCII
+ * character and ICU must be used.
+ */
+static const gchar muttum_fold_bases[MUTTUM_FOLD_TABLE_SIZE] = {
+  /* U+0000 */ 0, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  /* U+0008 */ 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+  /* U+0010 */ 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+  /* U+0018 */ 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+  /* U+0020 */ ' ', '!', '"', '#', '$', '%', '&', '\'',
+  /* U+0028 */ '(', ')', '*', '+', ',', '-', '.', '/',
+  /* U+0030 */ '0', '1', '2', '3', '4', '5', '6', '7',
+  /* U+0038 */ '8', '9', ':', ';', '<', '=', '>', '?',
+  /* U+0040 */ '@', 'a', 'b', 'c', 'd', 'e', 'f', 'g',
+  /* U+0048 */ 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o',
+  /* U+0050 */ 'p', 'q', 'r', 's', 't', 'u', 'v', 'w',
+  /* U+0058 */ 'x', 'y', 'z', '[', '\\', ']', '^', '_',
+  /* U+0060 */ '`', 'a', 'b', 'c', 'd', 'e', 'f', 'g',
+  /* U+0068 */ 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o',
+  /* U+0070 */ 'p', 'q', 'r', 's', 't', 'u', 'v', 'w',
+  /* U+0078 */ 'x', 'y', 'z', '{', '|', '}', '~', 0x7f,
+  /* U+0080 */ 0, 0, 0, 0, 0, 0, 0, 0,
+  /* U+0088 */ 0, 0, 0, 0, 0, 0, 0, 0,
+  /* U+0090 */ 0, 0, 0, 0, 0, 0, 0, 0,
+  /* U+0098 */ 0, 0, 0, 0, 0, 0, 0, 0,
+  /* U+00A0 */ 0, 0, 0, 0, 0, 0, 0, 0,
+  /* U+00A8 */ 0, 0, 0, 0, 0, 0, 0, 0,
+  /* U+00B0 */ 0, 0, 0, 0, 0, 0, 0, 0,
+  /* U+00B8 */ 0, 0, 0, 0, 0, 0, 0, 0,
+  /* U+00C0 */ 'a', 'a', 'a', 'a', 'a', 'a', 0, 'c',
+  /* U+00C8 */ 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i',
+  /* U+00D0 */ 0, 'n', 'o', 'o', 'o', 'o', 'o', 0,
+  /* U+00D8 */ 0, 'u', 'u', 'u', 'u', 'y', 0, 0,
+  /* U+00E0 */ 'a', 'a', 'a', 'a', 'a', 'a', 0, 'c',
+  /* U+00E8 */ 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i',
+  /* U+00F0 */ 0, 'n', 'o', 'o', 'o', 'o', 'o', 0,
+  /* U+00F8 */ 0, 'u', 'u', 'u', 'u', 'y', 0, 'y',
+  /* U+0100 */ 'a', 'a', 'a', 'a', 'a', 'a', 'c', 'c',
+  /* U+0108 */ 'c', 'c', 'c', 'c', 'c', 'c', 'd', 'd',
+  /* U+0110 */ 0, 0, 'e', 'e', 'e', 'e', 'e', 'e',
+  /* U+0118 */ 'e', 'e', 'e', 'e', 'g', 'g', 'g', 'g',
+  /* U+0120 */ 'g', 'g', 'g', 'g', 'h', 'h', 0, 0,
+  /* U+0128 */ 'i', 'i', 'i', 'i', 'i', 'i', 'i', 'i',
+  /* U+0130 */ 'i', 0, 0, 0, 'j', 'j', 'k', 'k',
+  /* U+0138 */ 0, 'l', 'l', 'l', 'l', 'l', 'l', 0,
+  /* U+0140 */ 0, 0, 0, 'n', 'n', 'n', 'n', 'n',
+  /* U+0148 */ 'n', 0, 0, 0, 'o', 'o', 'o', 'o',
+  /* U+0150 */ 'o', 'o', 0, 0, 'r', 'r', 'r', 'r',
+  /* U+0158 */ 'r', 'r', 's', 's', 's', 's', 's', 's',
+  /* U+0160 */ 's', 's', 't', 't', 't', 't', 0, 0,
+  /* U+0168 */ 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+  /* U+0170 */ 'u', 'u', 'u', 'u', 'w', 'w', 'y', 'y',
+  /* U+0178 */ 'y', 'z', 'z', 'z', 'z', 'z', 'z', 0,
+};
+
+/*
+ * Base letters of each character at primary collation strength: accents
+ * and strokes are ignored, ligatures expand to their letters. Empty for
+ * characters which can't be typed with a-z letters.
+ */
+static const gchar muttum_fold_letters[MUTTUM_FOLD_TABLE_SIZE][3] = {
+  /* U+0000 */ "", "", "", "", "", "", "", "",
+  /* U+0008 */ "", "", "", "", "", "", "", "",
+  /* U+0010 */ "", "", "", "", "", "", "", "",
+  /* U+0018 */ "", "", "", "", "", "", "", "",
+  /* U+0020 */ "", "", "", "", "", "", "", "",
+  /* U+0028 */ "", "", "", "", "", "", "", "",
+  /* U+0030 */ "", "", "", "", "", "", "", "",
+  /* U+0038 */ "", "", "", "", "", "", "", "",
+  /* U+0040 */ "", "a", "b", "c", "d", "e", "f", "g",
+  /* U+0048 */ "h", "i", "j", "k", "l", "m", "n", "o",
+  /* U+0050 */ "p", "q", "r", "s", "t", "u", "v", "w",
+  /* U+0058 */ "x", "y", "z", "", "", "", "", "",
+  /* U+0060 */ "", "a", "b", "c", "d", "e", "f", "g",
+  /* U+0068 */ "h", "i", "j", "k", "l", "m", "n", "o",
+  /* U+0070 */ "p", "q", "r", "s", "t", "u", "v", "w",
+  /* U+0078 */ "x", "y", "z", "", "", "", "", "",
+  /* U+0080 */ "", "", "", "", "", "", "", "",
+  /* U+0088 */ "", "", "", "", "", "", "", "",
+  /* U+0090 */ "", "", "", "", "", "", "", "",
+  /* U+0098 */ "", "", "", "", "", "", "", "",
+  /* U+00A0 */ "", "", "", "", "", "", "", "",
+  /* U+00A8 */ "", "", "", "", "", "", "", "",
+  /* U+00B0 */ "", "", "", "", "", "", "", "",
+  /* U+00B8 */ "", "", "", "", "", "", "", "",
+  /* U+00C0 */ "a", "a", "a", "a", "a", "a", "ae", "c",
+  /* U+00C8 */ "e", "e", "e", "e", "i", "i", "i", "i",
+  /* U+00D0 */ "", "n", "o", "o", "o", "o", "o", "",
+  /* U+00D8 */ "o", "u", "u", "u", "u", "y", "", "ss",
+  /* U+00E0 */ "a", "a", "a", "a", "a", "a", "ae", "c",
+  /* U+00E8 */ "e", "e", "e", "e", "i", "i", "i", "i",
+  /* U+00F0 */ "", "n", "o", "o", "o", "o", "o", "",
+  /* U+00F8 */ "o", "u", "u", "u", "u", "y", "", "y",
+  /* U+0100 */ "a", "a", "a", "a", "a", "a", "c", "c",
+  /* U+0108 */ "c", "c", "c", "c", "c", "c", "d", "d",
+  /* U+0110 */ "d", "d", "e", "e", "e", "e", "e", "e",
+  /* U+0118 */ "e", "e", "e", "e", "g", "g", "g", "g",
+  /* U+0120 */ "g", "g", "g", "g", "h", "h", "h", "h",
+  /* U+0128 */ "i", "i", "i", "i", "i", "i", "i", "i",
+  /* U+0130 */ "i", "", "ij", "ij", "j", "j", "k", "k",
+  /* U+0138 */ "", "l", "l", "l", "l", "l", "l", "",
+  /* U+0140 */ "", "l", "l", "n", "n", "n", "n", "n",
+  /* U+0148 */ "n", "", "", "", "o", "o", "o", "o",
+  /* U+0150 */ "o", "o", "oe", "oe", "r", "r", "r", "r",
+  /* U+0158 */ "r", "r", "s", "s", "s", "s", "s", "s",
+  /* U+0160 */ "s", "s", "t", "t", "t", "t", "t", "t",
+  /* U+0168 */ "u", "u", "u", "u", "u", "u", "u", "u",
+  /* U+0170 */ "u", "u", "u", "u", "w", "w", "y", "y",
+  /* U+0178 */ "y", "z", "z", "z", "z", "z", "z", "s",
+};
+
+/*
+ * muttum_fold_word:
+ * @folded: (out caller-allocates): @folded_size bytes
+ *
+ * Folds @word as the transliterator of
+ * muttum_dictionary_open_transliterator() does.
+ *
+ * Returns: %FALSE if @word has characters out of the table or doesn't fit
+ * in @folded, which is then undefined
+ */
+gboolean muttum_fold_word (
+    const gchar *word,
+    gchar *folded,
+    gsize folded_size)
+{
+  gsize size = 0;
+
+  for (const gchar *c = word; *c; c = g_utf8_next_char(c)) {
+    gunichar character = g_utf8_get_char(c);
+
+    if (character >= MUTTUM_FOLD_TABLE_SIZE || muttum_fold_bases[character] == 0
+        || size + 1 >= folded_size) {
+      return FALSE;
+    }
+    folded[size++] = muttum_fold_bases[character];
+  }
+
+  folded[size] = '\0';
+  return TRUE;
+}
+
+/*
+ * muttum_fold_key:
+ * @word: a valid UTF-8 word
+ *
+ * Returns: the fold key of @word, %MUTTUM_FOLD_KEY_NONE if it can't be typed
+ * or has more than %MUTTUM_FOLD_LENGTH_MAX letters, %MUTTUM_FOLD_KEY_UNKNOWN if
+ * it has characters out of the table
+ */
+guint64 muttum_fold_key (const gchar *word)
+{
+  guint64 key = 0;
+  guint length = 0;
+
+  for (const gchar *c = word; *c; c = g_utf8_next_char(c)) {
+    gunichar character = g_utf8_get_char(c);
+
+    if (character >= MUTTUM_FOLD_TABLE_SIZE) {
+      return MUTTUM_FOLD_KEY_UNKNOWN;
+    }
+
+    const gchar *letters = muttum_fold_letters[character];
+    if (letters[0] == '\0') {
+      return MUTTUM_FOLD_KEY_NONE;
+    }
+
+    for (guint i = 0; i < 2 && letters[i]; i += 1) {
+      if (length == MUTTUM_FOLD_LENGTH_MAX) {
+        return MUTTUM_FOLD_KEY_NONE;
+      }
+      length += 1;
+      key |= (guint64) (letters[i] - 'a' + 1)
+        << (MUTTUM_FOLD_LETTER_BITS * (MUTTUM_FOLD_LENGTH_MAX - length));
+    }
+  }
+
+  return key;
+}
+
+/*
+ * muttum_fold_pack:
+ * @letters: typed letters, not NUL terminated
+ *
+ * Returns: the fold key of @letters or %MUTTUM_FOLD_KEY_NONE if one isn't
+ * from 'a' to 'z'
+ */
+guint64 muttum_fold_pack (
+    const gchar *letters,
+    guint length)
+{
+  guint64 key = 0;
+
+  if (length > MUTTUM_FOLD_LENGTH_MAX) {
+    return MUTTUM_FOLD_KEY_NONE;
+  }
+
+  for (guint i = 0; i < length; i += 1) {
+    if (letters[i] < 'a' || letters[i] > 'z') {
+      return MUTTUM_FOLD_KEY_NONE;
+    }
+    key |= (guint64) (letters[i] - 'a' + 1)
+      << (MUTTUM_FOLD_LETTER_BITS * (MUTTUM_FOLD_LENGTH_MAX - 1 - i));
+  }
+
+  return key;
+}
+
+/*
+ * muttum_fold_unpack:
+ * @fold_key: a fold key, neither %MUTTUM_FOLD_KEY_NONE nor
+ *   %MUTTUM_FOLD_KEY_UNKNOWN
+ * @codes: (out caller-allocates): %MUTTUM_FOLD_LENGTH_MAX bytes filled with
+ *   the letter codes of @fold_key, from 'a' = 1 to 'z' = 26
+ *
+ * Returns: number of letters of @fold_key
+ */
+guint muttum_fold_unpack (
+    guint64 fold_key,
+    guint8 *codes)
+{
+  const guint64 mask = (1 << MUTTUM_FOLD_LETTER_BITS) - 1;
+  guint length = 0;
+
+  while (length < MUTTUM_FOLD_LENGTH_MAX) {
+    guint8 code = (fold_key >> (MUTTUM_FOLD_LETTER_BITS * (MUTTUM_FOLD_LENGTH_MAX - 1 - length))) & mask;
+    if (code == 0) {
+      break;
+    }
+    codes[length++] = code;
+  }
+
+  return length;
+}
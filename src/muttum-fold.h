@@ -0,0 +1,56 @@
+/* muttum-fold.h
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Folding of Latin words without ICU, for the characters up to Latin
+ * Extended-A (U+017F). Words using other characters are left to the ICU
+ * transliterator and collator of muttum-dictionary.h.
+ *
+ * Fold keys pack the base letters of a word in a guint64, 5 bits by letter
+ * from 'a' = 1 to 'z' = 26, the first letter in the highest bits: keys
+ * compare as their letters do and equal keys mean equal primary collation
+ * keys for the typed words.
+ * */
+
+#define MUTTUM_FOLD_LENGTH_MAX 12
+
+// The word can't be typed with a-z letters
+#define MUTTUM_FOLD_KEY_NONE G_GUINT64_CONSTANT(0)
+
+// The word has characters out of the table, it must be folded by ICU
+#define MUTTUM_FOLD_KEY_UNKNOWN G_MAXUINT64
+
+gboolean muttum_fold_word (const gchar *word,
+                           gchar *folded,
+                           gsize folded_size);
+
+guint64 muttum_fold_key (const gchar *word);
+
+guint64 muttum_fold_pack (const gchar *letters,
+                          guint length);
+
+guint muttum_fold_unpack (guint64 fold_key,
+                          guint8 *codes);
+
+G_END_DECLS
@@ -0,0 +1,433 @@
+/* muttum-lexicon.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gio/gio.h>
+
+#include "muttum-lexicon.h"
+#include "muttum-pattern-matrix.h"
+#include "muttum-trace.h"
+
+// Lexicons whose ICU clones are kept by each thread
+#define MUTTUM_LEXICON_THREAD_CACHE_SIZE 4
+
+struct _MuttumLexicon {
+  // Registry key, "locale\nuri\nmin-max"
+  gchar *key;
+  // Unique among every lexicon of the process, even evicted ones, so a
+  // thread cache slot can't match a newer lexicon at the same address
+  guint64 serial;
+  // Protected by the registry mutex
+  guint ref_count;
+
+  gchar *locale;
+  gchar *dictionary_uri;
+  gchar *index_path;
+  gchar *pattern_matrix_dir;
+  gchar *pattern_matrix_name;
+  guint word_length_min;
+  guint word_length_max;
+
+  // Words are loaded by the first acquire, concurrent acquires of the same
+  // lexicon wait for it while other lexicons load in parallel
+  GMutex load_mutex;
+  gboolean loaded;
+  MuttumDictionary *dictionary;
+  MuttumLexiconStats stats;
+
+  // ICU objects aren't thread safe: threads use their own clones, see
+  // muttum_lexicon_get_thread_cache()
+  UCollator *collator;
+  UTransliterator *transliterator;
+
+  // Folded playable words by length, built with the dictionary and read
+  // only afterwards, see muttum_lexicon_get_solver_lexicon()
+  MuttumSolverLexicon *solver_lexicons[MUTTUM_SOLVER_LENGTH_MAX + 1];
+};
+
+/*
+ * ICU objects cloned from the lexicon ones for the current thread, so rules
+ * are compiled only once by lexicon. Slots are reused round robin, a thread
+ * keeps clones of a few lexicons at most.
+ */
+typedef struct {
+  guint64 serial;
+  UCollator *collator;
+  UTransliterator *transliterator;
+} MuttumLexiconThreadSlot;
+
+typedef struct {
+  MuttumLexiconThreadSlot slots[MUTTUM_LEXICON_THREAD_CACHE_SIZE];
+  guint next_slot;
+} MuttumLexiconThreadCache;
+
+static GMutex muttum_lexicon_registry_mutex;
+static GHashTable *muttum_lexicon_registry;
+static guint64 muttum_lexicon_next_serial = 1;
+// Sum of every load of the process, protected by the registry mutex
+static MuttumLexiconStats muttum_lexicon_total_stats;
+
+static void muttum_lexicon_thread_slot_clear(MuttumLexiconThreadSlot *slot) {
+  if (slot->collator) {
+    ucol_close(slot->collator);
+  }
+  if (slot->transliterator) {
+    utrans_close(slot->transliterator);
+  }
+  slot->serial = 0;
+  slot->collator = NULL;
+  slot->transliterator = NULL;
+}
+
+static void muttum_lexicon_thread_cache_free(gpointer data) {
+  MuttumLexiconThreadCache *cache = data;
+
+  for (guint i = 0; i < MUTTUM_LEXICON_THREAD_CACHE_SIZE; i += 1) {
+    muttum_lexicon_thread_slot_clear(&cache->slots[i]);
+  }
+  g_free(cache);
+}
+
+static GPrivate muttum_lexicon_thread_cache = G_PRIVATE_INIT(muttum_lexicon_thread_cache_free);
+
+static void muttum_lexicon_free(MuttumLexicon *lexicon) {
+  for (guint length = 0; length <= MUTTUM_SOLVER_LENGTH_MAX; length += 1) {
+    muttum_solver_lexicon_free(lexicon->solver_lexicons[length]);
+  }
+
+  muttum_dictionary_free(lexicon->dictionary);
+  if (lexicon->collator) {
+    ucol_close(lexicon->collator);
+  }
+  if (lexicon->transliterator) {
+    utrans_close(lexicon->transliterator);
+  }
+  g_mutex_clear(&lexicon->load_mutex);
+
+  g_free(lexicon->key);
+  g_free(lexicon->locale);
+  g_free(lexicon->dictionary_uri);
+  g_free(lexicon->index_path);
+  g_free(lexicon->pattern_matrix_dir);
+  g_free(lexicon->pattern_matrix_name);
+  g_free(lexicon);
+}
+
+/*
+ * Builds the solver lexicon of each word length, run by the load so games
+ * only read them.
+ */
+static void muttum_lexicon_load_solver_lexicons(MuttumLexicon *lexicon) {
+  for (guint length = lexicon->word_length_min; length <= MIN(lexicon->word_length_max, MUTTUM_SOLVER_LENGTH_MAX); length += 1) {
+    GByteArray *words = muttum_dictionary_get_folded_playable(lexicon->dictionary, lexicon->transliterator, length);
+    MuttumSolverLexicon *solver_lexicon = muttum_solver_lexicon_new(length, words);
+
+    // Patterns are read from the precomputed matrix when it matches the words
+    if (lexicon->pattern_matrix_dir && lexicon->pattern_matrix_name) {
+      g_autofree gchar *matrix_name = g_strdup_printf("%s-%u.muttumpat", lexicon->pattern_matrix_name, length);
+      g_autofree gchar *matrix_path = g_build_filename(lexicon->pattern_matrix_dir, matrix_name, NULL);
+      g_autoptr(GError) error = NULL;
+      MuttumPatternMatrix *matrix = muttum_pattern_matrix_open(matrix_path, solver_lexicon, &error);
+
+      if (matrix) {
+        muttum_solver_lexicon_set_matrix(solver_lexicon, matrix);
+      } else {
+        g_debug("MuttumLexicon: unable to use pattern matrix: %s", error->message);
+      }
+    }
+
+    lexicon->solver_lexicons[length] = solver_lexicon;
+  }
+}
+
+/*
+ * Returns: %FALSE if the words couldn't be read, @lexicon is left unloaded
+ */
+static gboolean muttum_lexicon_load(MuttumLexicon *lexicon, GError **error) {
+  gint64 start_time = g_get_monotonic_time();
+  gint64 trace_time = MUTTUM_TRACE_BEGIN();
+
+  // Unicode collator give more tools to create dictionary
+  lexicon->collator = muttum_dictionary_open_collator(lexicon->locale);
+
+  // Transliterator to transform words to only base characters, its rules
+  // are compiled once
+  lexicon->transliterator = muttum_dictionary_open_transliterator();
+
+  // Map the precompiled index, the word list is only parsed when the index
+  // is missing or stale
+  g_autoptr(GFile) dictionary_file = g_file_new_for_uri(lexicon->dictionary_uri);
+  MuttumDictionaryIndex *index = NULL;
+
+  if (lexicon->index_path) {
+    g_autoptr(GError) index_error = NULL;
+    index = muttum_dictionary_index_open(
+        lexicon->index_path, dictionary_file,
+        lexicon->collator, lexicon->locale,
+        lexicon->word_length_min, lexicon->word_length_max,
+        &index_error);
+
+    if (!index) {
+      g_debug("MuttumLexicon: unable to use dictionary index: %s", index_error->message);
+    }
+  }
+
+  if (!index) {
+    // Same flat sorted layout as the index file, built in memory
+    index = muttum_dictionary_index_new(dictionary_file, lexicon->locale,
+        lexicon->word_length_min, lexicon->word_length_max,
+        error);
+
+    if (!index) {
+      g_prefix_error(error, "Error occured while reading dictionary: ");
+      g_clear_pointer(&lexicon->collator, ucol_close);
+      g_clear_pointer(&lexicon->transliterator, utrans_close);
+      return FALSE;
+    }
+  }
+
+  // Lexicon representation is selected at runtime
+  MuttumDictionaryBackend backend = muttum_dictionary_backend_from_string(
+      g_getenv("MUTTUM_DICTIONARY_BACKEND"));
+  lexicon->dictionary = muttum_dictionary_new(index, backend);
+  muttum_lexicon_load_solver_lexicons(lexicon);
+
+  MuttumLexiconStats *stats = &lexicon->stats;
+  stats->load_time = g_get_monotonic_time() - start_time;
+  stats->n_collapsed = muttum_dictionary_get_n_collapsed(lexicon->dictionary);
+  for (guint length = lexicon->word_length_min; length <= MIN(lexicon->word_length_max, MUTTUM_SOLVER_LENGTH_MAX); length += 1) {
+    stats->n_words[length] = muttum_dictionary_get_n_playable(lexicon->dictionary, length);
+  }
+
+  g_mutex_lock(&muttum_lexicon_registry_mutex);
+  muttum_lexicon_total_stats.load_time += stats->load_time;
+  muttum_lexicon_total_stats.n_collapsed += stats->n_collapsed;
+  for (guint length = 0; length <= MUTTUM_SOLVER_LENGTH_MAX; length += 1) {
+    muttum_lexicon_total_stats.n_words[length] += stats->n_words[length];
+  }
+  g_mutex_unlock(&muttum_lexicon_registry_mutex);
+
+  MUTTUM_TRACE_END(trace_time, "lexicon-load", "%s", lexicon->dictionary_uri);
+  g_debug("MuttumLexicon: %s loaded in %" G_GINT64_FORMAT " µs, dictionary uses %" G_GSIZE_FORMAT " bytes",
+      lexicon->dictionary_uri, stats->load_time,
+      muttum_dictionary_get_size(lexicon->dictionary));
+
+  return TRUE;
+}
+
+/*
+ * muttum_lexicon_acquire:
+ * @source: where to load the words from
+ *
+ * Finds the lexicon of @source in the registry, or adds it. Words are
+ * loaded by the first caller, concurrent callers of the same source wait
+ * until it has finished. When the words can't be read, the next caller
+ * tries again.
+ *
+ * Returns: (transfer full) (nullable): the lexicon, to give back with
+ * muttum_lexicon_release(), or %NULL if its words couldn't be read
+ */
+MuttumLexicon *muttum_lexicon_acquire(const MuttumLexiconSource *source, GError **error) {
+  g_return_val_if_fail(source != NULL, NULL);
+  g_return_val_if_fail(source->locale != NULL && source->dictionary_uri != NULL, NULL);
+
+  g_autofree gchar *key = g_strdup_printf("%s\n%s\n%u-%u", source->locale, source->dictionary_uri,
+      source->word_length_min, source->word_length_max);
+
+  g_mutex_lock(&muttum_lexicon_registry_mutex);
+
+  if (!muttum_lexicon_registry) {
+    muttum_lexicon_registry = g_hash_table_new(g_str_hash, g_str_equal);
+  }
+
+  MuttumLexicon *lexicon = g_hash_table_lookup(muttum_lexicon_registry, key);
+  if (lexicon) {
+    lexicon->ref_count += 1;
+  } else {
+    lexicon = g_new0(MuttumLexicon, 1);
+    lexicon->key = g_steal_pointer(&key);
+    lexicon->serial = muttum_lexicon_next_serial;
+    muttum_lexicon_next_serial += 1;
+    lexicon->ref_count = 1;
+    lexicon->locale = g_strdup(source->locale);
+    lexicon->dictionary_uri = g_strdup(source->dictionary_uri);
+    lexicon->index_path = g_strdup(source->index_path);
+    lexicon->pattern_matrix_dir = g_strdup(source->pattern_matrix_dir);
+    lexicon->pattern_matrix_name = g_strdup(source->pattern_matrix_name);
+    lexicon->word_length_min = source->word_length_min;
+    lexicon->word_length_max = source->word_length_max;
+    g_mutex_init(&lexicon->load_mutex);
+
+    g_hash_table_insert(muttum_lexicon_registry, lexicon->key, lexicon);
+  }
+
+  g_mutex_unlock(&muttum_lexicon_registry_mutex);
+
+  // Loading happens outside of the registry lock
+  g_mutex_lock(&lexicon->load_mutex);
+  if (!lexicon->loaded) {
+    lexicon->loaded = muttum_lexicon_load(lexicon, error);
+  }
+  gboolean loaded = lexicon->loaded;
+  g_mutex_unlock(&lexicon->load_mutex);
+
+  if (!loaded) {
+    muttum_lexicon_release(lexicon);
+    return NULL;
+  }
+
+  return lexicon;
+}
+
+/*
+ * muttum_lexicon_release:
+ *
+ * Gives back a lexicon from muttum_lexicon_acquire(). The last release
+ * evicts it from the registry and frees its words, a later acquire loads
+ * them again.
+ */
+void muttum_lexicon_release(MuttumLexicon *lexicon) {
+  if (!lexicon) {
+    return;
+  }
+
+  g_mutex_lock(&muttum_lexicon_registry_mutex);
+
+  g_assert(lexicon->ref_count > 0);
+  lexicon->ref_count -= 1;
+  gboolean evict = lexicon->ref_count == 0;
+  if (evict) {
+    g_hash_table_remove(muttum_lexicon_registry, lexicon->key);
+  }
+
+  g_mutex_unlock(&muttum_lexicon_registry_mutex);
+
+  if (evict) {
+    g_debug("MuttumLexicon: %s evicted", lexicon->dictionary_uri);
+    muttum_lexicon_free(lexicon);
+  }
+}
+
+const gchar *muttum_lexicon_get_locale(MuttumLexicon *lexicon) {
+  return lexicon->locale;
+}
+
+/*
+ * Returns: (transfer none): the words of the lexicon
+ */
+MuttumDictionary *muttum_lexicon_get_dictionary(MuttumLexicon *lexicon) {
+  return lexicon->dictionary;
+}
+
+/*
+ * Returns: (transfer none): ICU objects of @lexicon for the current thread,
+ * they are released when the thread exits or when its slot is reused.
+ */
+static MuttumLexiconThreadSlot *muttum_lexicon_get_thread_cache(MuttumLexicon *lexicon) {
+  MuttumLexiconThreadCache *cache = g_private_get(&muttum_lexicon_thread_cache);
+
+  if (!cache) {
+    cache = g_new0(MuttumLexiconThreadCache, 1);
+    g_private_set(&muttum_lexicon_thread_cache, cache);
+  }
+
+  for (guint i = 0; i < MUTTUM_LEXICON_THREAD_CACHE_SIZE; i += 1) {
+    if (cache->slots[i].serial == lexicon->serial) {
+      return &cache->slots[i];
+    }
+  }
+
+  MuttumLexiconThreadSlot *slot = &cache->slots[cache->next_slot];
+  cache->next_slot = (cache->next_slot + 1) % MUTTUM_LEXICON_THREAD_CACHE_SIZE;
+  muttum_lexicon_thread_slot_clear(slot);
+
+  UErrorCode status = U_ZERO_ERROR;
+#if U_ICU_VERSION_MAJOR_NUM >= 71
+  slot->collator = ucol_clone(lexicon->collator, &status);
+#else
+  slot->collator = ucol_safeClone(lexicon->collator, NULL, NULL, &status);
+#endif
+  if (U_FAILURE(status)) {
+    g_error("Unable to clone unicode collator");
+  }
+
+  slot->transliterator = utrans_clone(lexicon->transliterator, &status);
+  if (U_FAILURE(status)) {
+    g_error("Unable to clone unicode transliterator");
+  }
+
+  slot->serial = lexicon->serial;
+
+  return slot;
+}
+
+/*
+ * Returns: (transfer none): the collator of @lexicon for the current thread
+ */
+UCollator *muttum_lexicon_get_collator(MuttumLexicon *lexicon) {
+  return muttum_lexicon_get_thread_cache(lexicon)->collator;
+}
+
+/*
+ * Returns: (transfer none): the transliterator of @lexicon for the current
+ * thread
+ */
+UTransliterator *muttum_lexicon_get_transliterator(MuttumLexicon *lexicon) {
+  return muttum_lexicon_get_thread_cache(lexicon)->transliterator;
+}
+
+/*
+ * Returns: (transfer none) (nullable): folded playable words of @length
+ * letters, only words made of a-z letters are kept. %NULL when @length is out
+ * of the lexicon word lengths.
+ */
+MuttumSolverLexicon *muttum_lexicon_get_solver_lexicon(MuttumLexicon *lexicon, guint length) {
+  g_return_val_if_fail(length <= MUTTUM_SOLVER_LENGTH_MAX, NULL);
+
+  // Built by the load, never changed afterwards: no lock is needed
+  return lexicon->solver_lexicons[length];
+}
+
+/*
+ * muttum_lexicon_get_stats:
+ * @lexicon: (nullable): a lexicon or %NULL for the whole process
+ * @stats: (out caller-allocates): filled with the load statistics
+ *
+ * Without @lexicon, statistics are the sum of every lexicon loaded by the
+ * process, evicted ones included.
+ */
+void muttum_lexicon_get_stats(MuttumLexicon *lexicon, MuttumLexiconStats *stats) {
+  if (lexicon) {
+    *stats = lexicon->stats;
+    return;
+  }
+
+  g_mutex_lock(&muttum_lexicon_registry_mutex);
+  *stats = muttum_lexicon_total_stats;
+  g_mutex_unlock(&muttum_lexicon_registry_mutex);
+}
+
+/*
+ * Returns: number of lexicons currently in the registry
+ */
+guint muttum_lexicon_get_n_loaded(void) {
+  g_mutex_lock(&muttum_lexicon_registry_mutex);
+  guint n_loaded = muttum_lexicon_registry ? g_hash_table_size(muttum_lexicon_registry) : 0;
+  g_mutex_unlock(&muttum_lexicon_registry_mutex);
+
+  return n_loaded;
+}
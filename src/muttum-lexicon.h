@@ -0,0 +1,101 @@
+/* muttum-lexicon.h
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <unicode/ucol.h>
+#include <unicode/utrans.h>
+
+#include "muttum-dictionary.h"
+#include "muttum-solver.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Process wide registry of loaded lexicons, keyed by locale, word list and
+ * word lengths.
+ *
+ * A lexicon is loaded by its first muttum_lexicon_acquire(), shared by every
+ * later caller of the same source and freed by the last
+ * muttum_lexicon_release().
+ * */
+
+typedef struct _MuttumLexicon MuttumLexicon;
+
+/*
+ * MuttumLexiconSource:
+ * @locale: collation locale of the words, for instance "fr_FR"
+ * @dictionary_uri: URI of the word list, one word by line
+ * @index_path: (nullable): precompiled index of the word list, see
+ *   muttum-dictionary-compile
+ * @pattern_matrix_dir: (nullable): directory of the precomputed solver
+ *   patterns, see muttum-pattern-compile
+ * @pattern_matrix_name: (nullable): matrix files are named
+ *   "<name>-<length>.muttumpat"
+ * @word_length_min: shortest playable word
+ * @word_length_max: longest playable word
+ *
+ * Only @locale, @dictionary_uri and the word lengths identify the lexicon,
+ * other fields are read by the first acquire.
+ */
+typedef struct {
+  const gchar *locale;
+  const gchar *dictionary_uri;
+  const gchar *index_path;
+  const gchar *pattern_matrix_dir;
+  const gchar *pattern_matrix_name;
+  guint word_length_min;
+  guint word_length_max;
+} MuttumLexiconSource;
+
+MuttumLexicon *muttum_lexicon_acquire (const MuttumLexiconSource *source,
+                                       GError **error);
+
+void muttum_lexicon_release (MuttumLexicon *lexicon);
+
+const gchar *muttum_lexicon_get_locale (MuttumLexicon *lexicon);
+
+MuttumDictionary *muttum_lexicon_get_dictionary (MuttumLexicon *lexicon);
+
+UCollator *muttum_lexicon_get_collator (MuttumLexicon *lexicon);
+
+UTransliterator *muttum_lexicon_get_transliterator (MuttumLexicon *lexicon);
+
+MuttumSolverLexicon *muttum_lexicon_get_solver_lexicon (MuttumLexicon *lexicon,
+                                                        guint length);
+
+/*
+ * MuttumLexiconStats:
+ * @load_time: time spent loading the words, in microseconds
+ * @n_words: playable words by length
+ * @n_collapsed: words dropped as they collapsed on the collation key of
+ *   another word
+ */
+typedef struct {
+  gint64 load_time;
+  guint n_words[MUTTUM_SOLVER_LENGTH_MAX + 1];
+  guint n_collapsed;
+} MuttumLexiconStats;
+
+void muttum_lexicon_get_stats (MuttumLexicon *lexicon,
+                               MuttumLexiconStats *stats);
+
+guint muttum_lexicon_get_n_loaded (void);
+
+G_END_DECLS
@@ -0,0 +1,112 @@
+/* muttum-pattern-compile.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include "muttum-lexicon.h"
+#include "muttum-pattern-matrix.h"
+
+/*
+ * Build tool writing the pattern matrix of the words of one length, mapped
+ * by the engine solver. Words are loaded as the engine lexicon of MIN to
+ * MAX letters loads them, its matrices must be built with the same range.
+ *
+ * Usage: muttum-pattern-compile [--check] LOCALE MIN MAX LENGTH WORD_LIST OUTPUT
+ *
+ * With --check, OUTPUT is an existing matrix which is only opened against
+ * the words, the tool fails when the engine would reject it.
+ * */
+
+static gboolean
+muttum_pattern_compile_parse_length (const gchar *arg, guint64 min, guint64 max, guint64 *length)
+{
+	g_autoptr(GError) error = NULL;
+
+	if (!g_ascii_string_to_unsigned(arg, 10, min, max, length, &error)) {
+		g_printerr("Invalid word length: %s\n", error->message);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+	g_autoptr(GError) error = NULL;
+	const gchar *program = argv[0];
+	gboolean check = argc > 1 && g_strcmp0(argv[1], "--check") == 0;
+
+	if (check) {
+		argc -= 1;
+		argv += 1;
+	}
+
+	if (argc != 7) {
+		g_printerr("Usage: %s [--check] LOCALE MIN MAX LENGTH WORD_LIST OUTPUT\n", program);
+		return EXIT_FAILURE;
+	}
+
+	guint64 word_length_min = 0;
+	guint64 word_length_max = 0;
+	guint64 length = 0;
+	if (!muttum_pattern_compile_parse_length(argv[2], 2, MUTTUM_SOLVER_LENGTH_MAX, &word_length_min)
+	    || !muttum_pattern_compile_parse_length(argv[3], word_length_min, MUTTUM_SOLVER_LENGTH_MAX, &word_length_max)
+	    || !muttum_pattern_compile_parse_length(argv[4], word_length_min, word_length_max, &length)) {
+		return EXIT_FAILURE;
+	}
+
+	// Same words as the engine: the playable words of its lexicon, whose
+	// index holds every length of the range
+	g_autoptr(GFile) source = g_file_new_for_commandline_arg(argv[5]);
+	g_autofree gchar *dictionary_uri = g_file_get_uri(source);
+	MuttumLexiconSource lexicon_source = {
+		.locale = argv[1],
+		.dictionary_uri = dictionary_uri,
+		.word_length_min = word_length_min,
+		.word_length_max = word_length_max,
+	};
+	MuttumLexicon *lexicon = muttum_lexicon_acquire(&lexicon_source, &error);
+	if (!lexicon) {
+		g_printerr("Unable to read word list: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	MuttumSolverLexicon *solver_lexicon = muttum_lexicon_get_solver_lexicon(lexicon, length);
+	gboolean done = FALSE;
+
+	if (check) {
+		MuttumPatternMatrix *matrix = muttum_pattern_matrix_open(argv[6], solver_lexicon, &error);
+		if (matrix) {
+			muttum_pattern_matrix_free(matrix);
+			done = TRUE;
+		} else {
+			g_printerr("Pattern matrix rejected: %s\n", error->message);
+		}
+	} else {
+		done = muttum_pattern_matrix_write(solver_lexicon, argv[6], &error);
+		if (!done) {
+			g_printerr("Unable to write pattern matrix: %s\n", error->message);
+		}
+	}
+
+	muttum_lexicon_release(lexicon);
+
+	return done ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,260 @@
+/* muttum-pattern-matrix.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "muttum-pattern-matrix.h"
+
+// Guesses scored by each task of the generator
+#define MUTTUM_PATTERN_MATRIX_ROWS_BY_TASK 64
+
+struct _MuttumPatternMatrix {
+  GBytes *bytes;
+  const MuttumPatternMatrixHeader *header;
+};
+
+typedef struct {
+  MuttumSolverLexicon *lexicon;
+  const MuttumPatternMatrixHeader *header;
+  guint8 *contents;
+} MuttumPatternMatrixBuild;
+
+typedef struct {
+  gchar letter;
+  guint start;
+  guint end;
+} MuttumPatternMatrixTask;
+
+static guint muttum_pattern_matrix_pattern_size_for (guint length)
+{
+  guint n_patterns = 1;
+  for (guint i = 1; i < length; i += 1) {
+    n_patterns *= 3;
+  }
+
+  return n_patterns <= G_MAXUINT8 + 1 ? 1 : 2;
+}
+
+static void muttum_pattern_matrix_build_rows (gpointer data, gpointer user_data)
+{
+  MuttumPatternMatrixTask *task = data;
+  MuttumPatternMatrixBuild *build = user_data;
+  guint length = muttum_solver_lexicon_get_length(build->lexicon);
+  guint first = 0;
+  guint n_words = muttum_solver_lexicon_get_first_letter_range(build->lexicon, task->letter, &first);
+  const guint64 *words = muttum_solver_lexicon_get_packed_words(build->lexicon) + first;
+  guint8 *block = build->contents + build->header->block_offsets[task->letter - 'a'];
+  g_autofree guint16 *patterns = g_new(guint16, n_words);
+
+  for (guint guess = task->start; guess < task->end; guess += 1) {
+    muttum_score_batch(words[guess], words, n_words, length, patterns);
+
+    if (build->header->pattern_size == 1) {
+      guint8 *row = block + (gsize) guess * n_words;
+      for (guint target = 0; target < n_words; target += 1) {
+        row[target] = muttum_solver_pattern_index(patterns[target]);
+      }
+    } else {
+      guint16 *row = (guint16 *) block + (gsize) guess * n_words;
+      for (guint target = 0; target < n_words; target += 1) {
+        row[target] = muttum_solver_pattern_index(patterns[target]);
+      }
+    }
+  }
+
+  g_free(task);
+}
+
+/*
+ * muttum_pattern_matrix_write:
+ * @output_path: the pattern matrix file to write
+ *
+ * Scores every pair of words of the same first letter, rows are spread on
+ * one thread by core.
+ */
+gboolean muttum_pattern_matrix_write (
+    MuttumSolverLexicon *lexicon,
+    const gchar *output_path,
+    GError **error)
+{
+  MuttumPatternMatrixHeader header = { 0 };
+  guint length = muttum_solver_lexicon_get_length(lexicon);
+
+  memcpy(header.magic, MUTTUM_PATTERN_MATRIX_MAGIC, sizeof(header.magic));
+  header.version = MUTTUM_PATTERN_MATRIX_VERSION;
+  header.length = length;
+  header.n_words = muttum_solver_lexicon_get_n_words(lexicon);
+  header.pattern_size = muttum_pattern_matrix_pattern_size_for(length);
+  memcpy(header.checksum, muttum_solver_lexicon_get_checksum(lexicon), sizeof(header.checksum));
+
+  guint64 size = sizeof(header);
+  for (gchar letter = 'a'; letter <= 'z'; letter += 1) {
+    guint first = 0;
+    guint n_words = muttum_solver_lexicon_get_first_letter_range(lexicon, letter, &first);
+
+    header.first_letter_offsets[letter - 'a'] = first;
+    header.block_offsets[letter - 'a'] = size;
+    size += (guint64) n_words * n_words * header.pattern_size;
+    size = (size + 7) & ~G_GUINT64_CONSTANT(7);
+  }
+  header.first_letter_offsets[26] = header.n_words;
+
+  g_autofree guint8 *contents = g_try_malloc0(size);
+  if (!contents) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+        "Unable to allocate %" G_GUINT64_FORMAT " bytes for the pattern matrix", size);
+    return FALSE;
+  }
+  memcpy(contents, &header, sizeof(header));
+
+  MuttumPatternMatrixBuild build = {
+    .lexicon = lexicon,
+    .header = (const MuttumPatternMatrixHeader *) contents,
+    .contents = contents,
+  };
+
+  GThreadPool *pool = g_thread_pool_new(muttum_pattern_matrix_build_rows, &build,
+      g_get_num_processors(), TRUE, error);
+  if (!pool) {
+    return FALSE;
+  }
+
+  for (gchar letter = 'a'; letter <= 'z'; letter += 1) {
+    guint first = 0;
+    guint n_words = muttum_solver_lexicon_get_first_letter_range(lexicon, letter, &first);
+
+    for (guint start = 0; start < n_words; start += MUTTUM_PATTERN_MATRIX_ROWS_BY_TASK) {
+      MuttumPatternMatrixTask *task = g_new(MuttumPatternMatrixTask, 1);
+      task->letter = letter;
+      task->start = start;
+      task->end = MIN(n_words, start + MUTTUM_PATTERN_MATRIX_ROWS_BY_TASK);
+      g_thread_pool_push(pool, task, NULL);
+    }
+  }
+
+  // Waits for every task
+  g_thread_pool_free(pool, FALSE, TRUE);
+
+  return g_file_set_contents(output_path, (const gchar *) contents, size, error);
+}
+
+/*
+ * muttum_pattern_matrix_open:
+ * @path: the pattern matrix built by muttum-pattern-compile
+ * @lexicon: the lexicon the matrix must have been built from
+ *
+ * Maps the matrix in memory. The matrix is rejected when it was built from
+ * other words, for instance after a dictionary change.
+ *
+ * Returns: (transfer full) (nullable): the mapped matrix or %NULL when it's
+ * missing or stale
+ */
+MuttumPatternMatrix *muttum_pattern_matrix_open (
+    const gchar *path,
+    MuttumSolverLexicon *lexicon,
+    GError **error)
+{
+  GMappedFile *file = g_mapped_file_new(path, FALSE, error);
+  if (!file) {
+    return NULL;
+  }
+
+  // Bytes keep a reference on the mapping
+  g_autoptr(GBytes) bytes = g_mapped_file_get_bytes(file);
+  g_mapped_file_unref(file);
+
+  gsize file_size = 0;
+  const guint8 *contents = g_bytes_get_data(bytes, &file_size);
+  const MuttumPatternMatrixHeader *header = (const MuttumPatternMatrixHeader *) contents;
+  guint length = muttum_solver_lexicon_get_length(lexicon);
+
+  if (file_size < sizeof(MuttumPatternMatrixHeader)
+      || memcmp(header->magic, MUTTUM_PATTERN_MATRIX_MAGIC, sizeof(header->magic)) != 0
+      || header->version != MUTTUM_PATTERN_MATRIX_VERSION) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+        "Pattern matrix %s is corrupted or has an unknown version", path);
+    return NULL;
+  }
+
+  if (header->length != length
+      || header->n_words != muttum_solver_lexicon_get_n_words(lexicon)
+      || header->pattern_size != muttum_pattern_matrix_pattern_size_for(length)
+      || memcmp(header->checksum, muttum_solver_lexicon_get_checksum(lexicon), sizeof(header->checksum)) != 0) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+        "Pattern matrix %s is stale", path);
+    return NULL;
+  }
+
+  for (gchar letter = 'a'; letter <= 'z'; letter += 1) {
+    guint first = 0;
+    guint n_words = muttum_solver_lexicon_get_first_letter_range(lexicon, letter, &first);
+    guint64 offset = header->block_offsets[letter - 'a'];
+    guint64 block_size = (guint64) n_words * n_words * header->pattern_size;
+
+    if (header->first_letter_offsets[letter - 'a'] != first
+        || offset % 8 != 0
+        || offset > file_size
+        || block_size > file_size - offset) {
+      g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+          "Pattern matrix %s is corrupted", path);
+      return NULL;
+    }
+  }
+
+  MuttumPatternMatrix *matrix = g_new(MuttumPatternMatrix, 1);
+  matrix->header = header;
+  matrix->bytes = g_steal_pointer(&bytes);
+
+  return matrix;
+}
+
+void muttum_pattern_matrix_free (MuttumPatternMatrix *matrix)
+{
+  if (!matrix) {
+    return;
+  }
+
+  g_bytes_unref(matrix->bytes);
+  g_free(matrix);
+}
+
+/*
+ * Returns: number of bytes of each pattern index
+ */
+guint muttum_pattern_matrix_get_pattern_size (MuttumPatternMatrix *matrix)
+{
+  return matrix->header->pattern_size;
+}
+
+/*
+ * muttum_pattern_matrix_get_block:
+ *
+ * Rows are guesses and columns are targets, both numbered from the first
+ * word of @first_letter in the lexicon.
+ *
+ * Returns: (transfer none): pattern indexes of words starting by @first_letter
+ */
+const guint8 *muttum_pattern_matrix_get_block (
+    MuttumPatternMatrix *matrix,
+    gchar first_letter)
+{
+  g_return_val_if_fail(first_letter >= 'a' && first_letter <= 'z', NULL);
+
+  const guint8 *contents = (const guint8 *) matrix->header;
+  return contents + matrix->header->block_offsets[first_letter - 'a'];
+}
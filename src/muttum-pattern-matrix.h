@@ -0,0 +1,76 @@
+/* muttum-pattern-matrix.h
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+
+#include "muttum-solver.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Precomputed guess x target feedback patterns of a solver lexicon, built by
+ * muttum-pattern-compile and mapped by the engine.
+ * */
+
+#define MUTTUM_PATTERN_MATRIX_MAGIC "MUTTUMPM"
+#define MUTTUM_PATTERN_MATRIX_VERSION 1
+
+/*
+ * Pattern matrix layout (host endianness):
+ *
+ *  - MuttumPatternMatrixHeader
+ *  - one block by first letter: for each guess, the pattern index (see
+ *    muttum_solver_pattern_index()) against each target of the same first
+ *    letter, on pattern_size bytes
+ *
+ * Only words of the same first letter are compared by the game, so other
+ * pairs aren't stored. Pattern indexes fit in one byte up to 6 letters and
+ * in two bytes for 7 and 8 letters.
+ * */
+typedef struct {
+  gchar magic[8];
+  guint32 version;
+  guint32 length;
+  guint32 n_words;
+  guint32 pattern_size;
+  guint8 checksum[MUTTUM_SOLVER_CHECKSUM_SIZE];
+  guint32 first_letter_offsets[27];
+  guint32 padding;
+  guint64 block_offsets[26];
+} MuttumPatternMatrixHeader;
+
+gboolean muttum_pattern_matrix_write (MuttumSolverLexicon *lexicon,
+                                      const gchar *output_path,
+                                      GError **error);
+
+MuttumPatternMatrix *muttum_pattern_matrix_open (const gchar *path,
+                                                 MuttumSolverLexicon *lexicon,
+                                                 GError **error);
+
+void muttum_pattern_matrix_free (MuttumPatternMatrix *matrix);
+
+guint muttum_pattern_matrix_get_pattern_size (MuttumPatternMatrix *matrix);
+
+const guint8 *muttum_pattern_matrix_get_block (MuttumPatternMatrix *matrix,
+                                               gchar first_letter);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MuttumPatternMatrix, muttum_pattern_matrix_free)
+
+G_END_DECLS
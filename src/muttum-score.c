@@ -0,0 +1,452 @@
+/* muttum-score.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "muttum-score.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define MUTTUM_SCORE_HAVE_X86 1
+  #include <immintrin.h>
+#endif
+
+/*
+ * Feedback scoring kernel shared by the engine and the solver.
+ *
+ * Packed words hold letter i in byte i (bits 8 * i to 8 * i + 7), unused
+ * bytes are zero. A letter of the guess is present when the target has
+ * more occurrences of it, out of well placed positions, than the guess has
+ * before it, out of well placed positions: this is the left to right rule
+ * of muttum_engine_validate().
+ * */
+
+typedef void (*MuttumScoreBatchFunc) (guint64 guess,
+                                      const guint64 *targets,
+                                      gsize n_targets,
+                                      guint length,
+                                      guint16 *patterns);
+
+/*
+ * Each kernel is instantiated for every word length from
+ * MUTTUM_SCORE_SPECIALIZED_LENGTH_MIN, with the length as a constant: letter
+ * loops are unrolled and masks are computed at compile time. Shorter words
+ * use the generic kernel.
+ */
+#define MUTTUM_SCORE_SPECIALIZED_LENGTH_MIN 4
+
+typedef struct {
+  const gchar *name;
+  // Any length
+  MuttumScoreBatchFunc batch;
+  // NULL for the lengths without a specialized kernel
+  MuttumScoreBatchFunc batch_by_length[MUTTUM_SCORE_WORD_LENGTH_MAX + 1];
+} MuttumScoreKernel;
+
+#if defined(__GNUC__)
+  #define MUTTUM_SCORE_INLINE static inline __attribute__((always_inline))
+#else
+  #define MUTTUM_SCORE_INLINE static inline
+#endif
+
+static inline guint64 muttum_score_word_mask (guint length)
+{
+  return length >= MUTTUM_SCORE_WORD_LENGTH_MAX ? G_MAXUINT64 : (G_GUINT64_CONSTANT(1) << (8 * length)) - 1;
+}
+
+static inline guint8 muttum_score_letter (guint64 packed, guint position)
+{
+  return (packed >> (8 * position)) & 0xff;
+}
+
+/*
+ * Returns: a word with byte j set to 1 for positions j before @position
+ * holding the same letter as @position in @guess
+ */
+static inline guint64 muttum_score_before_mask (guint64 guess, guint position)
+{
+  guint64 mask = 0;
+  guint8 letter = muttum_score_letter(guess, position);
+
+  for (guint j = 0; j < position; j += 1) {
+    if (muttum_score_letter(guess, j) == letter) {
+      mask |= G_GUINT64_CONSTANT(1) << (8 * j);
+    }
+  }
+
+  return mask;
+}
+
+/**
+ * muttum_score_pack_word:
+ * @word: (array length=length): letters of the word
+ * @length: number of letters, at most %MUTTUM_SCORE_WORD_LENGTH_MAX
+ *
+ * Returns: the packed word
+ */
+guint64 muttum_score_pack_word (const gchar *word, guint length)
+{
+  g_return_val_if_fail(length <= MUTTUM_SCORE_WORD_LENGTH_MAX, 0);
+
+  guint64 packed = 0;
+  for (guint i = 0; i < length; i += 1) {
+    packed |= (guint64) (guint8) word[i] << (8 * i);
+  }
+
+  return packed;
+}
+
+/**
+ * muttum_score_unpack_word:
+ * @packed: a packed word
+ * @length: number of letters, at most %MUTTUM_SCORE_WORD_LENGTH_MAX
+ * @word: (out caller-allocates) (array length=length): letters of the word
+ *
+ * Writes the @length letters of @packed in @word, without NUL terminator.
+ */
+void muttum_score_unpack_word (guint64 packed, guint length, gchar *word)
+{
+  g_return_if_fail(length <= MUTTUM_SCORE_WORD_LENGTH_MAX);
+
+  for (guint i = 0; i < length; i += 1) {
+    word[i] = muttum_score_letter(packed, i);
+  }
+}
+
+/*
+ * Scores @guess against @target, inlined with a constant @length by the
+ * specialized kernels.
+ */
+MUTTUM_SCORE_INLINE guint16 muttum_score_word_body (guint64 guess, guint64 target, guint length)
+{
+  guint64 word_mask = muttum_score_word_mask(length);
+  guess &= word_mask;
+  target &= word_mask;
+
+  // Unused bytes are equal, so they are never counted as letters
+  guint8 well_placed = 0;
+  for (guint i = 0; i < MUTTUM_SCORE_WORD_LENGTH_MAX; i += 1) {
+    if (muttum_score_letter(guess, i) == muttum_score_letter(target, i)) {
+      well_placed |= 1 << i;
+    }
+  }
+
+  guint8 present = 0;
+  for (guint i = 0; i < length; i += 1) {
+    if (well_placed & (1 << i)) {
+      continue;
+    }
+
+    guint8 letter = muttum_score_letter(guess, i);
+    guint in_target = 0;
+    guint in_guess_before = 0;
+    for (guint j = 0; j < length; j += 1) {
+      if (well_placed & (1 << j)) {
+        continue;
+      }
+      in_target += muttum_score_letter(target, j) == letter;
+      in_guess_before += j < i && muttum_score_letter(guess, j) == letter;
+    }
+
+    if (in_target > in_guess_before) {
+      present |= 1 << i;
+    }
+  }
+
+  guint8 length_mask = (1 << length) - 1;
+  return (well_placed & length_mask) | ((guint16) (present & length_mask) << 8);
+}
+
+/**
+ * muttum_score_word:
+ * @guess: the packed guess
+ * @target: the packed word to find
+ * @length: number of letters, at most %MUTTUM_SCORE_WORD_LENGTH_MAX
+ *
+ * Returns: the feedback pattern of @guess against @target, see
+ * MUTTUM_SCORE_PATTERN_WELL_PLACED() and MUTTUM_SCORE_PATTERN_PRESENT()
+ */
+guint16 muttum_score_word (guint64 guess, guint64 target, guint length)
+{
+  g_return_val_if_fail(length <= MUTTUM_SCORE_WORD_LENGTH_MAX, 0);
+
+  switch (length) {
+    case 4: return muttum_score_word_body(guess, target, 4);
+    case 5: return muttum_score_word_body(guess, target, 5);
+    case 6: return muttum_score_word_body(guess, target, 6);
+    case 7: return muttum_score_word_body(guess, target, 7);
+    case 8: return muttum_score_word_body(guess, target, 8);
+    default: return muttum_score_word_body(guess, target, length);
+  }
+}
+
+MUTTUM_SCORE_INLINE void muttum_score_batch_scalar_body (
+    guint64 guess,
+    const guint64 *targets,
+    gsize n_targets,
+    guint length,
+    guint16 *patterns)
+{
+  for (gsize i = 0; i < n_targets; i += 1) {
+    patterns[i] = muttum_score_word_body(guess, targets[i], length);
+  }
+}
+
+#ifdef MUTTUM_SCORE_HAVE_X86
+
+/*
+ * SIMD kernels score two (SSE2) or four (AVX2) targets at once, one target
+ * by 64 bits lane. Occurrences of each guess letter are counted by lane
+ * with a sum of absolute differences over 0/1 bytes.
+ */
+
+__attribute__((target("sse2")))
+MUTTUM_SCORE_INLINE void muttum_score_batch_sse2_body (
+    guint64 guess,
+    const guint64 *targets,
+    gsize n_targets,
+    guint length,
+    guint16 *patterns)
+{
+  guint64 word_mask = muttum_score_word_mask(length);
+  guint8 length_mask = (1 << length) - 1;
+  guess &= word_mask;
+
+  const __m128i guess_lanes = _mm_set1_epi64x(guess);
+  const __m128i word_mask_lanes = _mm_set1_epi64x(word_mask);
+  const __m128i ones = _mm_set1_epi8(1);
+  const __m128i zero = _mm_setzero_si128();
+  __m128i letters[MUTTUM_SCORE_WORD_LENGTH_MAX];
+  __m128i before[MUTTUM_SCORE_WORD_LENGTH_MAX];
+
+  for (guint i = 0; i < length; i += 1) {
+    letters[i] = _mm_set1_epi8(muttum_score_letter(guess, i));
+    before[i] = _mm_set1_epi64x(muttum_score_before_mask(guess, i));
+  }
+
+  gsize t = 0;
+  for (; t + 2 <= n_targets; t += 2) {
+    __m128i target = _mm_and_si128(_mm_loadu_si128((const __m128i *) (targets + t)), word_mask_lanes);
+    __m128i equal = _mm_cmpeq_epi8(target, guess_lanes);
+    guint well_placed = _mm_movemask_epi8(equal);
+    __m128i not_well_placed = _mm_andnot_si128(equal, ones);
+    guint present[2] = { 0, 0 };
+
+    for (guint i = 0; i < length; i += 1) {
+      __m128i in_target = _mm_and_si128(_mm_cmpeq_epi8(target, letters[i]), not_well_placed);
+      __m128i target_count = _mm_sad_epu8(in_target, zero);
+      __m128i guess_count = _mm_sad_epu8(_mm_and_si128(before[i], not_well_placed), zero);
+      guint greater = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(target_count, guess_count)));
+      present[0] |= (greater & 1) << i;
+      present[1] |= ((greater >> 2) & 1) << i;
+    }
+
+    for (guint lane = 0; lane < 2; lane += 1) {
+      guint8 lane_well_placed = (well_placed >> (8 * lane)) & length_mask;
+      guint8 lane_present = present[lane] & ~lane_well_placed & length_mask;
+      patterns[t + lane] = lane_well_placed | ((guint16) lane_present << 8);
+    }
+  }
+
+  muttum_score_batch_scalar_body(guess, targets + t, n_targets - t, length, patterns + t);
+}
+
+__attribute__((target("avx2")))
+MUTTUM_SCORE_INLINE void muttum_score_batch_avx2_body (
+    guint64 guess,
+    const guint64 *targets,
+    gsize n_targets,
+    guint length,
+    guint16 *patterns)
+{
+  guint64 word_mask = muttum_score_word_mask(length);
+  guint8 length_mask = (1 << length) - 1;
+  guess &= word_mask;
+
+  const __m256i guess_lanes = _mm256_set1_epi64x(guess);
+  const __m256i word_mask_lanes = _mm256_set1_epi64x(word_mask);
+  const __m256i ones = _mm256_set1_epi8(1);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i letters[MUTTUM_SCORE_WORD_LENGTH_MAX];
+  __m256i before[MUTTUM_SCORE_WORD_LENGTH_MAX];
+
+  for (guint i = 0; i < length; i += 1) {
+    letters[i] = _mm256_set1_epi8(muttum_score_letter(guess, i));
+    before[i] = _mm256_set1_epi64x(muttum_score_before_mask(guess, i));
+  }
+
+  gsize t = 0;
+  for (; t + 4 <= n_targets; t += 4) {
+    __m256i target = _mm256_and_si256(_mm256_loadu_si256((const __m256i *) (targets + t)), word_mask_lanes);
+    __m256i equal = _mm256_cmpeq_epi8(target, guess_lanes);
+    guint32 well_placed = _mm256_movemask_epi8(equal);
+    __m256i not_well_placed = _mm256_andnot_si256(equal, ones);
+    guint present[4] = { 0, 0, 0, 0 };
+
+    for (guint i = 0; i < length; i += 1) {
+      __m256i in_target = _mm256_and_si256(_mm256_cmpeq_epi8(target, letters[i]), not_well_placed);
+      __m256i target_count = _mm256_sad_epu8(in_target, zero);
+      __m256i guess_count = _mm256_sad_epu8(_mm256_and_si256(before[i], not_well_placed), zero);
+      guint greater = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target_count, guess_count)));
+      for (guint lane = 0; lane < 4; lane += 1) {
+        present[lane] |= ((greater >> lane) & 1) << i;
+      }
+    }
+
+    for (guint lane = 0; lane < 4; lane += 1) {
+      guint8 lane_well_placed = (well_placed >> (8 * lane)) & length_mask;
+      guint8 lane_present = present[lane] & ~lane_well_placed & length_mask;
+      patterns[t + lane] = lane_well_placed | ((guint16) lane_present << 8);
+    }
+  }
+
+  muttum_score_batch_scalar_body(guess, targets + t, n_targets - t, length, patterns + t);
+}
+
+#endif /* MUTTUM_SCORE_HAVE_X86 */
+
+
+/*
+ * Defines the generic muttum_score_batch_<kernel>() and its specialized
+ * muttum_score_batch_<kernel>_<length>() from muttum_score_batch_<kernel>_body().
+ * Specialized kernels ignore their length argument.
+ */
+#define MUTTUM_SCORE_DEFINE_BATCH(kernel, attributes, length) \
+  attributes static void muttum_score_batch_##kernel##_##length ( \
+      guint64 guess, const guint64 *targets, gsize n_targets, \
+      G_GNUC_UNUSED guint n_letters, guint16 *patterns) \
+  { \
+    muttum_score_batch_##kernel##_body(guess, targets, n_targets, length, patterns); \
+  }
+
+#define MUTTUM_SCORE_DEFINE_KERNEL(kernel, attributes) \
+  attributes static void muttum_score_batch_##kernel ( \
+      guint64 guess, const guint64 *targets, gsize n_targets, \
+      guint length, guint16 *patterns) \
+  { \
+    muttum_score_batch_##kernel##_body(guess, targets, n_targets, length, patterns); \
+  } \
+  MUTTUM_SCORE_DEFINE_BATCH(kernel, attributes, 4) \
+  MUTTUM_SCORE_DEFINE_BATCH(kernel, attributes, 5) \
+  MUTTUM_SCORE_DEFINE_BATCH(kernel, attributes, 6) \
+  MUTTUM_SCORE_DEFINE_BATCH(kernel, attributes, 7) \
+  MUTTUM_SCORE_DEFINE_BATCH(kernel, attributes, 8)
+
+#define MUTTUM_SCORE_KERNEL(kernel) \
+  { #kernel, muttum_score_batch_##kernel, { \
+      [4] = muttum_score_batch_##kernel##_4, \
+      [5] = muttum_score_batch_##kernel##_5, \
+      [6] = muttum_score_batch_##kernel##_6, \
+      [7] = muttum_score_batch_##kernel##_7, \
+      [8] = muttum_score_batch_##kernel##_8, \
+    } }
+
+G_STATIC_ASSERT(MUTTUM_SCORE_WORD_LENGTH_MAX == 8);
+
+MUTTUM_SCORE_DEFINE_KERNEL(scalar, )
+#ifdef MUTTUM_SCORE_HAVE_X86
+MUTTUM_SCORE_DEFINE_KERNEL(sse2, __attribute__((target("sse2"))))
+MUTTUM_SCORE_DEFINE_KERNEL(avx2, __attribute__((target("avx2"))))
+#endif
+
+static const MuttumScoreKernel muttum_score_kernels[] = {
+#ifdef MUTTUM_SCORE_HAVE_X86
+  MUTTUM_SCORE_KERNEL(avx2),
+  MUTTUM_SCORE_KERNEL(sse2),
+#endif
+  MUTTUM_SCORE_KERNEL(scalar),
+};
+
+static gboolean muttum_score_kernel_is_supported (const MuttumScoreKernel *kernel)
+{
+#ifdef MUTTUM_SCORE_HAVE_X86
+  __builtin_cpu_init();
+  if (kernel->batch == muttum_score_batch_avx2) {
+    return __builtin_cpu_supports("avx2");
+  }
+  if (kernel->batch == muttum_score_batch_sse2) {
+    return __builtin_cpu_supports("sse2");
+  }
+#endif
+  return kernel->batch == muttum_score_batch_scalar;
+}
+
+/*
+ * Selects the best kernel supported by the CPU once, MUTTUM_SCORE_KERNEL
+ * may name a kernel to use instead, for instance to compare them.
+ */
+static const MuttumScoreKernel *muttum_score_get_kernel (void)
+{
+  static gsize selected = 0;
+
+  if (g_once_init_enter(&selected)) {
+    const gchar *name = g_getenv("MUTTUM_SCORE_KERNEL");
+    const MuttumScoreKernel *kernel = NULL;
+
+    for (guint i = 0; i < G_N_ELEMENTS(muttum_score_kernels) && !kernel; i += 1) {
+      if (name && g_strcmp0(name, muttum_score_kernels[i].name) != 0) {
+        continue;
+      }
+      if (muttum_score_kernel_is_supported(&muttum_score_kernels[i])) {
+        kernel = &muttum_score_kernels[i];
+      }
+    }
+
+    if (!kernel) {
+      g_warning("Unknown or unsupported score kernel %s, using scalar", name);
+      kernel = &muttum_score_kernels[G_N_ELEMENTS(muttum_score_kernels) - 1];
+    }
+
+    g_once_init_leave(&selected, (gsize) kernel);
+  }
+
+  return (const MuttumScoreKernel *) selected;
+}
+
+/**
+ * muttum_score_batch:
+ * @guess: the packed guess
+ * @targets: (array length=n_targets): packed words to find
+ * @n_targets: number of targets
+ * @length: number of letters, at most %MUTTUM_SCORE_WORD_LENGTH_MAX
+ * @patterns: (out caller-allocates) (array length=n_targets): feedback
+ *   patterns of @guess against each target
+ *
+ * Scores @guess against every target with the fastest kernel supported by
+ * the CPU, specialized for @length when it's a common word length.
+ */
+void muttum_score_batch (
+    guint64 guess,
+    const guint64 *targets,
+    gsize n_targets,
+    guint length,
+    guint16 *patterns)
+{
+  g_return_if_fail(length <= MUTTUM_SCORE_WORD_LENGTH_MAX);
+
+  const MuttumScoreKernel *kernel = muttum_score_get_kernel();
+  MuttumScoreBatchFunc batch = kernel->batch_by_length[length];
+  (batch ? batch : kernel->batch)(guess, targets, n_targets, length, patterns);
+}
+
+/**
+ * muttum_score_get_kernel_name:
+ *
+ * Returns: (transfer none): the name of the kernel used by muttum_score_batch()
+ */
+const gchar *muttum_score_get_kernel_name (void)
+{
+  return muttum_score_get_kernel()->name;
+}
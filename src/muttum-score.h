@@ -0,0 +1,67 @@
+/* muttum-score.h
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * MUTTUM_SCORE_WORD_LENGTH_MAX:
+ *
+ * Maximum number of letters of a packed word.
+ */
+#define MUTTUM_SCORE_WORD_LENGTH_MAX 8
+
+/**
+ * MUTTUM_SCORE_PATTERN_WELL_PLACED:
+ * @pattern: a feedback pattern
+ *
+ * Bit i is set if the letter at position i is well placed.
+ */
+#define MUTTUM_SCORE_PATTERN_WELL_PLACED(pattern) ((guint8) ((pattern) & 0xff))
+
+/**
+ * MUTTUM_SCORE_PATTERN_PRESENT:
+ * @pattern: a feedback pattern
+ *
+ * Bit i is set if the letter at position i is present but not well placed.
+ */
+#define MUTTUM_SCORE_PATTERN_PRESENT(pattern) ((guint8) ((pattern) >> 8))
+
+guint64 muttum_score_pack_word (const gchar *word,
+                                guint length);
+
+void muttum_score_unpack_word (guint64 packed,
+                               guint length,
+                               gchar *word);
+
+guint16 muttum_score_word (guint64 guess,
+                           guint64 target,
+                           guint length);
+
+void muttum_score_batch (guint64 guess,
+                         const guint64 *targets,
+                         gsize n_targets,
+                         guint length,
+                         guint16 *patterns);
+
+const gchar *muttum_score_get_kernel_name (void);
+
+G_END_DECLS
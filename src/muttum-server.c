@@ -0,0 +1,690 @@
+/* muttum-server.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib-unix.h>
+#include <glib/gstdio.h>
+#include <gio/gunixsocketaddress.h>
+
+#include "muttum.h"
+
+/*
+ * Game server hosting many concurrent sessions on a UNIX socket, it only
+ * uses the public MuttumEngine API.
+ *
+ * Connections are spread round robin on worker threads which run their own
+ * GMainContext, so a connection and its sessions are only used by one
+ * thread. Every session shares the words loaded once by the process.
+ *
+ * Commands are lines of text, each one is answered by one line:
+ *   new              game ID LENGTH FIRST_LETTER
+ *   guess ID WORD    row ID ROW LETTERS STATES continue|won|lost [WORD]
+ *   hint ID          hint ID WORD|-
+ *   end ID           ended ID
+ *   park ID          parked ID SAVE, the session is ended
+ *   resume SAVE      game ID LENGTH FIRST_LETTER
+ *   quit             the connection is closed
+ *
+ * Failed commands are answered by "error ID|- MESSAGE". STATES has one
+ * symbol by letter: '+' well placed, '?' present and '-' not present. The
+ * word to find is only given once the game is lost. SAVE is the game saved
+ * by muttum_engine_serialize() in base64, so idle sessions can be kept out
+ * of the server. Games too large for a save can't be parked, they go on.
+ *
+ * A connection plays at most MUTTUM_SERVER_SESSIONS_MAX games at once, new
+ * and resume are answered by "error - too many games" over it. Commands of
+ * a client which doesn't read its answers wait until they are sent.
+ * */
+
+#define MUTTUM_SERVER_SOCKET_NAME "muttum.sock"
+#define MUTTUM_SERVER_READ_SIZE 4096
+// Longest command, connections sending longer lines are closed
+#define MUTTUM_SERVER_LINE_SIZE 256
+// Ended sessions kept by each connection to be reset by the next games
+#define MUTTUM_SERVER_SPARES_MAX 64
+// Games played at once by each connection
+#define MUTTUM_SERVER_SESSIONS_MAX 256
+// Pending answers of a connection, it isn't read while they are over
+#define MUTTUM_SERVER_OUTPUT_MAX (64 * 1024)
+
+typedef struct {
+	GThread *thread;
+	GMainContext *context;
+	GMainLoop *loop;
+} MuttumServerWorker;
+
+typedef struct {
+	MuttumServerWorker *workers;
+	guint n_workers;
+	guint next_worker;
+} MuttumServer;
+
+typedef struct {
+	MuttumServerWorker *worker;
+	GSocketConnection *connection;
+	GSocket *socket;
+	GSource *in_source;
+	GSource *out_source;
+	GString *input;
+	GString *output;
+	// Sessions by id, ids of ended sessions are reused
+	GPtrArray *sessions;
+	GArray *free_ids;
+	// Engines of ended sessions, see MUTTUM_SERVER_SPARES_MAX
+	GPtrArray *spares;
+	gboolean is_closing;
+} MuttumServerConnection;
+
+static gint muttum_server_n_sessions = 0;
+
+static gchar
+muttum_server_state_symbol (MuttumLetterState state)
+{
+	switch (state) {
+	case MUTTUM_LETTER_WELL_PLACED:
+		return '+';
+	case MUTTUM_LETTER_PRESENT:
+		return '?';
+	case MUTTUM_LETTER_NOT_PRESENT:
+		return '-';
+	default:
+		return ' ';
+	}
+}
+
+static void
+muttum_server_session_free (gpointer data)
+{
+	if (data) {
+		g_object_unref(data);
+	}
+}
+
+static void
+muttum_server_source_clear (GSource **source)
+{
+	if (*source) {
+		g_source_destroy(*source);
+		g_source_unref(*source);
+		*source = NULL;
+	}
+}
+
+static void
+muttum_server_connection_free (MuttumServerConnection *client)
+{
+	muttum_server_source_clear(&client->in_source);
+	muttum_server_source_clear(&client->out_source);
+	g_io_stream_close(G_IO_STREAM(client->connection), NULL, NULL);
+	g_object_unref(client->connection);
+	g_string_free(client->input, TRUE);
+	g_string_free(client->output, TRUE);
+	g_ptr_array_unref(client->sessions);
+	g_array_unref(client->free_ids);
+	g_ptr_array_unref(client->spares);
+	g_free(client);
+}
+
+/*
+ * Returns: (transfer none) (nullable): the session @id of @client, %NULL
+ * if it doesn't exist or is ended
+ */
+static MuttumEngine *
+muttum_server_connection_get_session (MuttumServerConnection *client, const gchar *id, guint *index)
+{
+	guint64 value = 0;
+
+	if (!id || client->sessions->len == 0
+	    || !g_ascii_string_to_unsigned(id, 10, 0, client->sessions->len - 1, &value, NULL)) {
+		return NULL;
+	}
+
+	*index = value;
+	return g_ptr_array_index(client->sessions, value);
+}
+
+static void
+muttum_server_connection_add_session (MuttumServerConnection *client, MuttumEngine *engine)
+{
+	guint id = client->sessions->len;
+
+	if (client->free_ids->len > 0) {
+		id = g_array_index(client->free_ids, guint, client->free_ids->len - 1);
+		g_array_set_size(client->free_ids, client->free_ids->len - 1);
+		g_ptr_array_index(client->sessions, id) = engine;
+	} else {
+		g_ptr_array_add(client->sessions, engine);
+	}
+	g_atomic_int_inc(&muttum_server_n_sessions);
+
+	guint length = 0;
+	const MuttumLetter *board = muttum_engine_peek_board(engine, NULL, &length);
+	g_string_append_printf(client->output, "game %u %u %c\n", id, length, board[0].letter);
+}
+
+/*
+ * Answers an error if @client plays MUTTUM_SERVER_SESSIONS_MAX games.
+ */
+static gboolean
+muttum_server_connection_is_full (MuttumServerConnection *client)
+{
+	if (client->sessions->len - client->free_ids->len < MUTTUM_SERVER_SESSIONS_MAX) {
+		return FALSE;
+	}
+
+	g_string_append(client->output, "error - too many games\n");
+	return TRUE;
+}
+
+static void
+muttum_server_connection_new_session (MuttumServerConnection *client)
+{
+	MuttumEngine *engine = NULL;
+
+	if (muttum_server_connection_is_full(client)) {
+		return;
+	}
+
+	// Resetting an ended session doesn't allocate
+	if (client->spares->len > 0) {
+		engine = g_ptr_array_steal_index_fast(client->spares, client->spares->len - 1);
+		muttum_engine_reset(engine);
+	} else {
+		g_autoptr(GError) error = NULL;
+		engine = g_initable_new(MUTTUM_TYPE_ENGINE, NULL, &error, NULL);
+		if (!engine) {
+			g_string_append_printf(client->output, "error - %s\n", error->message);
+			return;
+		}
+	}
+
+	muttum_server_connection_add_session(client, engine);
+}
+
+static void
+muttum_server_connection_resume_session (MuttumServerConnection *client, const gchar *save)
+{
+	g_autoptr(GError) error = NULL;
+	gsize size = 0;
+
+	if (!save) {
+		g_string_append(client->output, "error - missing game\n");
+		return;
+	}
+
+	if (muttum_server_connection_is_full(client)) {
+		return;
+	}
+
+	guchar *data = g_base64_decode(save, &size);
+	g_autoptr(GBytes) bytes = g_bytes_new_take(data, size);
+	MuttumEngine *engine = muttum_engine_deserialize(bytes, &error);
+
+	if (!engine) {
+		g_string_append_printf(client->output, "error - %s\n", error->message);
+		return;
+	}
+
+	muttum_server_connection_add_session(client, engine);
+}
+
+static void
+muttum_server_connection_end_session (MuttumServerConnection *client, guint id, MuttumEngine *engine)
+{
+	if (client->spares->len < MUTTUM_SERVER_SPARES_MAX) {
+		g_ptr_array_add(client->spares, engine);
+	} else {
+		g_object_unref(engine);
+	}
+	g_ptr_array_index(client->sessions, id) = NULL;
+	g_array_append_val(client->free_ids, id);
+}
+
+static void
+muttum_server_connection_guess (MuttumServerConnection *client, guint id, MuttumEngine *engine, const gchar *guess)
+{
+	g_autoptr(GError) error = NULL;
+	guint row_index = muttum_engine_get_current_row(engine);
+	guint length = 0;
+	const MuttumLetter *board = muttum_engine_peek_board(engine, NULL, &length);
+	const MuttumLetter *row = &board[row_index * length];
+
+	if (muttum_engine_get_game_state(engine) != MUTTUM_ENGINE_STATE_CONTINUE) {
+		g_string_append_printf(client->output, "error %u game is over\n", id);
+		return;
+	}
+
+	gsize guess_length = strlen(guess);
+	for (gsize i = 0; i < guess_length; i += 1) {
+		if (guess[i] < 'a' || guess[i] > 'z') {
+			g_string_append_printf(client->output, "error %u only letters are allowed\n", id);
+			return;
+		}
+	}
+
+	if (guess_length != length || guess[0] != row[0].letter) {
+		g_string_append_printf(client->output, "error %u expected %u letters starting with %c\n",
+		                       id, length, row[0].letter);
+		return;
+	}
+
+	// The first letter is already given by the engine
+	for (gsize i = 1; i < guess_length; i += 1) {
+		muttum_engine_add_letter(engine, guess[i]);
+	}
+
+	muttum_engine_validate(engine, &error);
+
+	if (error) {
+		for (gsize i = 1; i < guess_length; i += 1) {
+			muttum_engine_remove_letter(engine);
+		}
+		g_string_append_printf(client->output, "error %u %s\n", id, error->message);
+		return;
+	}
+
+	g_string_append_printf(client->output, "row %u %u ", id, row_index);
+	for (guint col = 0; col < length; col += 1) {
+		g_string_append_c(client->output, row[col].letter);
+	}
+	g_string_append_c(client->output, ' ');
+	for (guint col = 0; col < length; col += 1) {
+		g_string_append_c(client->output, muttum_server_state_symbol(row[col].state));
+	}
+
+	switch (muttum_engine_get_game_state(engine)) {
+	case MUTTUM_ENGINE_STATE_WON:
+		g_string_append(client->output, " won\n");
+		break;
+	case MUTTUM_ENGINE_STATE_LOST: {
+		g_autoptr(GString) word = muttum_engine_get_word(engine);
+		g_string_append_printf(client->output, " lost %s\n", word->str);
+		break;
+	}
+	default:
+		g_string_append(client->output, " continue\n");
+		break;
+	}
+}
+
+static void
+muttum_server_connection_handle (MuttumServerConnection *client, gchar *line)
+{
+	g_auto(GStrv) args = g_strsplit(g_strstrip(line), " ", 3);
+	MuttumEngine *engine = NULL;
+	guint id = 0;
+
+	if (!args[0] || args[0][0] == '\0') {
+		return;
+	}
+
+	if (g_strcmp0(args[0], "new") == 0) {
+		muttum_server_connection_new_session(client);
+		return;
+	} else if (g_strcmp0(args[0], "resume") == 0) {
+		muttum_server_connection_resume_session(client, args[1]);
+		return;
+	} else if (g_strcmp0(args[0], "quit") == 0) {
+		client->is_closing = TRUE;
+		return;
+	} else if (g_strcmp0(args[0], "guess") != 0
+	           && g_strcmp0(args[0], "hint") != 0
+	           && g_strcmp0(args[0], "end") != 0
+	           && g_strcmp0(args[0], "park") != 0) {
+		g_string_append(client->output, "error - unknown command\n");
+		return;
+	}
+
+	engine = muttum_server_connection_get_session(client, args[1], &id);
+	if (!engine) {
+		g_string_append(client->output, "error - unknown game\n");
+		return;
+	}
+
+	if (g_strcmp0(args[0], "guess") == 0) {
+		if (!args[2]) {
+			g_string_append_printf(client->output, "error %u missing word\n", id);
+			return;
+		}
+		muttum_server_connection_guess(client, id, engine, args[2]);
+	} else if (g_strcmp0(args[0], "hint") == 0) {
+		g_autofree gchar *hint = muttum_engine_suggest_guess(engine);
+		g_string_append_printf(client->output, "hint %u %s\n", id, hint ? hint : "-");
+	} else if (g_strcmp0(args[0], "park") == 0) {
+		g_autoptr(GBytes) bytes = muttum_engine_serialize(engine);
+		gsize size = 0;
+
+		// Boards too large for a save keep playing
+		if (!bytes) {
+			g_string_append_printf(client->output, "error %u game can't be parked\n", id);
+			return;
+		}
+
+		const guchar *data = g_bytes_get_data(bytes, &size);
+		g_autofree gchar *save = g_base64_encode(data, size);
+
+		muttum_server_connection_end_session(client, id, engine);
+		g_string_append_printf(client->output, "parked %u %s\n", id, save);
+	} else {
+		muttum_server_connection_end_session(client, id, engine);
+		g_string_append_printf(client->output, "ended %u\n", id);
+	}
+}
+
+static gboolean muttum_server_on_writable (GSocket *socket, GIOCondition condition, gpointer data);
+
+/*
+ * Sends as much of the pending answers as the socket accepts, the rest is
+ * sent once it's writable again. Returns %FALSE if the connection failed.
+ */
+static gboolean
+muttum_server_connection_flush (MuttumServerConnection *client)
+{
+	while (client->output->len > 0) {
+		g_autoptr(GError) error = NULL;
+		gssize n_sent = g_socket_send(client->socket, client->output->str, client->output->len, NULL, &error);
+
+		if (n_sent < 0) {
+			if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+				return FALSE;
+			}
+
+			if (!client->out_source) {
+				client->out_source = g_socket_create_source(client->socket, G_IO_OUT, NULL);
+				g_source_set_callback(client->out_source, (GSourceFunc) muttum_server_on_writable, client, NULL);
+				g_source_attach(client->out_source, client->worker->context);
+			}
+			return TRUE;
+		}
+
+		g_string_erase(client->output, 0, n_sent);
+	}
+
+	muttum_server_source_clear(&client->out_source);
+	return TRUE;
+}
+
+/*
+ * Sends the pending answers. Returns %FALSE once @client is freed: the
+ * connection failed, or it's closing and every answer was sent.
+ */
+static gboolean
+muttum_server_connection_send (MuttumServerConnection *client)
+{
+	if (!muttum_server_connection_flush(client)
+	    || (client->is_closing && client->output->len == 0)) {
+		muttum_server_connection_free(client);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*
+ * Handles the complete lines read until the pending answers go over
+ * MUTTUM_SERVER_OUTPUT_MAX, the other lines wait until they are sent.
+ */
+static void
+muttum_server_connection_process (MuttumServerConnection *client)
+{
+	// Commands may be pipelined, every complete line is handled
+	gsize start = 0;
+	gchar *end = NULL;
+	while (!client->is_closing && client->output->len < MUTTUM_SERVER_OUTPUT_MAX
+	       && (end = memchr(client->input->str + start, '\n', client->input->len - start))) {
+		*end = '\0';
+		muttum_server_connection_handle(client, client->input->str + start);
+		start = end - client->input->str + 1;
+	}
+	g_string_erase(client->input, 0, start);
+
+	// Only a partial line is left when every line could be handled
+	if (!client->is_closing && client->output->len < MUTTUM_SERVER_OUTPUT_MAX
+	    && client->input->len > MUTTUM_SERVER_LINE_SIZE) {
+		client->is_closing = TRUE;
+	}
+}
+
+static gboolean muttum_server_on_readable (GSocket *socket, GIOCondition condition, gpointer data);
+
+static void
+muttum_server_connection_read_start (MuttumServerConnection *client)
+{
+	client->in_source = g_socket_create_source(client->socket, G_IO_IN | G_IO_HUP | G_IO_ERR, NULL);
+	g_source_set_callback(client->in_source, (GSourceFunc) muttum_server_on_readable, client, NULL);
+	g_source_attach(client->in_source, client->worker->context);
+}
+
+static gboolean
+muttum_server_on_writable (G_GNUC_UNUSED GSocket *socket,
+                           G_GNUC_UNUSED GIOCondition condition,
+                           gpointer data)
+{
+	MuttumServerConnection *client = data;
+
+	// The source is cleared by the flush once every answer is sent
+	if (!muttum_server_connection_send(client)) {
+		return G_SOURCE_REMOVE;
+	}
+
+	// Reading stopped on too many pending answers goes on once they are
+	// sent, with the lines already read
+	if (!client->in_source && !client->is_closing && client->output->len < MUTTUM_SERVER_OUTPUT_MAX) {
+		muttum_server_connection_process(client);
+		if (!muttum_server_connection_send(client)) {
+			return G_SOURCE_REMOVE;
+		}
+		if (!client->is_closing && client->output->len < MUTTUM_SERVER_OUTPUT_MAX) {
+			muttum_server_connection_read_start(client);
+		}
+	}
+
+	return client->out_source ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+static gboolean
+muttum_server_on_readable (GSocket *socket,
+                           G_GNUC_UNUSED GIOCondition condition,
+                           gpointer data)
+{
+	MuttumServerConnection *client = data;
+	gchar buffer[MUTTUM_SERVER_READ_SIZE];
+	g_autoptr(GError) error = NULL;
+	gssize n_read = g_socket_receive(socket, buffer, sizeof(buffer), NULL, &error);
+
+	if (n_read < 0 && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+		return G_SOURCE_CONTINUE;
+	}
+
+	// Closed by the client
+	if (n_read <= 0) {
+		muttum_server_connection_free(client);
+		return G_SOURCE_REMOVE;
+	}
+
+	g_string_append_len(client->input, buffer, n_read);
+	muttum_server_connection_process(client);
+
+	if (!muttum_server_connection_send(client)) {
+		return G_SOURCE_REMOVE;
+	}
+
+	// Remaining answers are sent before closing, and a client not reading
+	// its answers isn't read either until they are sent
+	if (client->is_closing || client->output->len >= MUTTUM_SERVER_OUTPUT_MAX) {
+		muttum_server_source_clear(&client->in_source);
+		return G_SOURCE_REMOVE;
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+/*
+ * Runs in the worker of @data, the connection is only used by this thread
+ * from now on.
+ */
+static gboolean
+muttum_server_connection_start (gpointer data)
+{
+	MuttumServerConnection *client = data;
+
+	client->socket = g_socket_connection_get_socket(client->connection);
+	g_socket_set_blocking(client->socket, FALSE);
+	muttum_server_connection_read_start(client);
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+muttum_server_on_incoming (G_GNUC_UNUSED GSocketService *service,
+                           GSocketConnection *connection,
+                           G_GNUC_UNUSED GObject *source_object,
+                           gpointer user_data)
+{
+	MuttumServer *server = user_data;
+	MuttumServerConnection *client = g_new0(MuttumServerConnection, 1);
+
+	client->worker = &server->workers[server->next_worker];
+	server->next_worker = (server->next_worker + 1) % server->n_workers;
+
+	client->connection = g_object_ref(connection);
+	client->input = g_string_new(NULL);
+	client->output = g_string_new(NULL);
+	client->sessions = g_ptr_array_new_with_free_func(muttum_server_session_free);
+	client->free_ids = g_array_new(FALSE, FALSE, sizeof(guint));
+	client->spares = g_ptr_array_new_with_free_func(g_object_unref);
+
+	g_main_context_invoke(client->worker->context, muttum_server_connection_start, client);
+
+	return TRUE;
+}
+
+static gpointer
+muttum_server_worker_run (gpointer data)
+{
+	MuttumServerWorker *worker = data;
+
+	g_main_context_push_thread_default(worker->context);
+	g_main_loop_run(worker->loop);
+	g_main_context_pop_thread_default(worker->context);
+
+	return NULL;
+}
+
+static gboolean
+muttum_server_on_signal (gpointer user_data)
+{
+	g_main_loop_quit(user_data);
+	return G_SOURCE_REMOVE;
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+	g_autoptr(GOptionContext) context = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autofree gchar *socket_path = NULL;
+	gint n_workers = 0;
+
+	GOptionEntry entries[] = {
+		{ "socket", 's', 0, G_OPTION_ARG_FILENAME, &socket_path, "Listen on PATH (default: muttum.sock in the user runtime directory)", "PATH" },
+		{ "workers", 'w', 0, G_OPTION_ARG_INT, &n_workers, "Serve connections from N threads (default: one by core)", "N" },
+		{ NULL },
+	};
+
+	context = g_option_context_new("- host Muttum games on a UNIX socket");
+	g_option_context_add_main_entries(context, entries, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("%s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	if (!socket_path) {
+		socket_path = g_build_filename(g_get_user_runtime_dir(), MUTTUM_SERVER_SOCKET_NAME, NULL);
+	}
+
+	if (n_workers <= 0) {
+		n_workers = g_get_num_processors();
+	}
+
+	// Words are loaded once before the first connection, and stay loaded
+	// while sessions come and go
+	g_autoptr(MuttumEngine) keeper = g_initable_new(MUTTUM_TYPE_ENGINE, NULL, &error, NULL);
+	if (!keeper) {
+		g_printerr("%s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	MuttumServer server = {
+		.workers = g_new0(MuttumServerWorker, n_workers),
+		.n_workers = n_workers,
+	};
+
+	for (guint i = 0; i < server.n_workers; i += 1) {
+		MuttumServerWorker *worker = &server.workers[i];
+		g_autofree gchar *name = g_strdup_printf("muttum-worker-%u", i);
+
+		worker->context = g_main_context_new();
+		worker->loop = g_main_loop_new(worker->context, FALSE);
+		worker->thread = g_thread_new(name, muttum_server_worker_run, worker);
+	}
+
+	// A previous server may have left its socket
+	g_unlink(socket_path);
+
+	g_autoptr(GSocketService) service = g_socket_service_new();
+	g_autoptr(GSocketAddress) address = g_unix_socket_address_new(socket_path);
+	if (!g_socket_listener_add_address(G_SOCKET_LISTENER(service), address,
+	                                   G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT,
+	                                   NULL, NULL, &error)) {
+		g_printerr("Unable to listen on %s: %s\n", socket_path, error->message);
+		return EXIT_FAILURE;
+	}
+
+	g_autoptr(GMainLoop) loop = g_main_loop_new(NULL, FALSE);
+	g_signal_connect(service, "incoming", G_CALLBACK(muttum_server_on_incoming), &server);
+	g_unix_signal_add(SIGINT, muttum_server_on_signal, loop);
+	g_unix_signal_add(SIGTERM, muttum_server_on_signal, loop);
+
+	g_socket_service_start(service);
+	g_print("listening %s\n", socket_path);
+
+	g_main_loop_run(loop);
+
+	g_socket_service_stop(service);
+	g_socket_listener_close(G_SOCKET_LISTENER(service));
+	g_unlink(socket_path);
+
+	// Open connections are dropped with the process
+	for (guint i = 0; i < server.n_workers; i += 1) {
+		MuttumServerWorker *worker = &server.workers[i];
+		g_main_loop_quit(worker->loop);
+		g_thread_join(worker->thread);
+		g_main_loop_unref(worker->loop);
+		g_main_context_unref(worker->context);
+	}
+	g_free(server.workers);
+
+	g_print("sessions %d\n", g_atomic_int_get(&muttum_server_n_sessions));
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,636 @@
+/* muttum-solver.c
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "muttum-pattern-matrix.h"
+#include "muttum-solver.h"
+
+// Number of chunks queued by worker thread, so threads finishing early
+// take remaining chunks
+#define MUTTUM_SOLVER_CHUNKS_BY_THREAD 4
+
+struct _MuttumSolverLexicon {
+  guint length;
+  guint n_words;
+  gchar *words;
+  guint64 *packed_words;
+  guint8 checksum[MUTTUM_SOLVER_CHECKSUM_SIZE];
+
+  // Optional precomputed patterns of the words
+  MuttumPatternMatrix *matrix;
+
+  // Words starting by letter l are in [offsets[l - 'a'], offsets[l - 'a' + 1])
+  guint first_letter_offsets[27];
+};
+
+/*
+ * Words of one first letter still consistent with the validated rows: bit i
+ * of the set stands for the word at position first + i of the lexicon.
+ */
+struct _MuttumSolverCandidates {
+  MuttumSolverLexicon *lexicon;
+  gchar first_letter;
+  guint first;
+  guint n_words;
+  guint count;
+  guint64 *bits;
+  // Blocks allocated for bits, kept by muttum_solver_candidates_reset()
+  guint n_blocks_allocated;
+};
+
+typedef struct {
+  const guint64 *guesses;
+  guint n_guesses;
+  guint length;
+  guint n_patterns;
+  const guint64 *candidates;
+  const guint *candidate_positions;
+  guint n_candidates;
+  const guint64 *candidate_bits;
+
+  // Pattern indexes of the first letter block of the matrix, if any
+  const guint8 *matrix_block;
+  guint pattern_size;
+
+  GMutex mutex;
+  GCond cond;
+  guint pending;
+} MuttumSolverJob;
+
+typedef struct {
+  MuttumSolverJob *job;
+  guint start;
+  guint end;
+
+  // Best guess of the chunk
+  gint64 best;
+  gdouble best_entropy;
+} MuttumSolverChunk;
+
+static inline gboolean muttum_solver_bits_test (const guint64 *bits, guint i)
+{
+  return (bits[i / 64] >> (i % 64)) & 1;
+}
+
+// Position of the lowest set bit of a non zero block
+static inline guint muttum_solver_bits_first (guint64 bits)
+{
+#if defined(__GNUC__)
+  return __builtin_ctzll(bits);
+#else
+  guint position = 0;
+  while (!(bits & 1)) {
+    bits >>= 1;
+    position += 1;
+  }
+  return position;
+#endif
+}
+
+static gint muttum_solver_lexicon_compare (
+    gconstpointer a,
+    gconstpointer b,
+    gpointer user_data)
+{
+  return memcmp(a, b, GPOINTER_TO_UINT(user_data));
+}
+
+/*
+ * muttum_solver_lexicon_new:
+ * @length: number of letters of each word
+ * @words: (transfer full): concatenated words of @length a-z letters
+ *
+ * Returns: (transfer full): the lexicon, sorted without duplicates
+ */
+MuttumSolverLexicon *muttum_solver_lexicon_new (
+    guint length,
+    GByteArray *words)
+{
+  g_return_val_if_fail(length > 0 && length <= MUTTUM_SOLVER_LENGTH_MAX, NULL);
+  g_return_val_if_fail(words->len % length == 0, NULL);
+
+  MuttumSolverLexicon *lexicon = g_new0(MuttumSolverLexicon, 1);
+  guint n_words = words->len / length;
+
+  g_qsort_with_data(words->data, n_words, length,
+      muttum_solver_lexicon_compare, GUINT_TO_POINTER(length));
+
+  // Several spellings fold to the same letters
+  guint n_unique = 0;
+  for (guint i = 0; i < n_words; i += 1) {
+    const guint8 *word = words->data + i * length;
+    if (n_unique == 0 || memcmp(words->data + (n_unique - 1) * length, word, length) != 0) {
+      memmove(words->data + n_unique * length, word, length);
+      n_unique += 1;
+    }
+  }
+
+  lexicon->length = length;
+  lexicon->n_words = n_unique;
+  g_byte_array_set_size(words, n_unique * length);
+  lexicon->words = (gchar *) g_byte_array_free(words, FALSE);
+
+  guint position = 0;
+  for (guint letter = 0; letter < 26; letter += 1) {
+    lexicon->first_letter_offsets[letter] = position;
+    while (position < n_unique && lexicon->words[position * length] == (gchar) ('a' + letter)) {
+      position += 1;
+    }
+  }
+  lexicon->first_letter_offsets[26] = position;
+
+  lexicon->packed_words = g_new(guint64, n_unique);
+  for (guint i = 0; i < n_unique; i += 1) {
+    lexicon->packed_words[i] = muttum_score_pack_word(lexicon->words + i * length, length);
+  }
+
+  // Precomputed patterns are only valid for the same words
+  gsize checksum_size = sizeof(lexicon->checksum);
+  g_autoptr(GChecksum) checksum = g_checksum_new(G_CHECKSUM_SHA256);
+  g_checksum_update(checksum, (const guchar *) lexicon->words, n_unique * length);
+  g_checksum_get_digest(checksum, lexicon->checksum, &checksum_size);
+
+  return lexicon;
+}
+
+void muttum_solver_lexicon_free (MuttumSolverLexicon *lexicon)
+{
+  if (!lexicon) {
+    return;
+  }
+
+  g_free(lexicon->words);
+  g_free(lexicon->packed_words);
+  muttum_pattern_matrix_free(lexicon->matrix);
+  g_free(lexicon);
+}
+
+guint muttum_solver_lexicon_get_n_words (MuttumSolverLexicon *lexicon)
+{
+  return lexicon->n_words;
+}
+
+guint muttum_solver_lexicon_get_length (MuttumSolverLexicon *lexicon)
+{
+  return lexicon->length;
+}
+
+/*
+ * Returns: (transfer none): the packed words
+ */
+const guint64 *muttum_solver_lexicon_get_packed_words (MuttumSolverLexicon *lexicon)
+{
+  return lexicon->packed_words;
+}
+
+/*
+ * muttum_solver_lexicon_get_first_letter_range:
+ * @first: (out): position of the first word starting by @letter
+ *
+ * Returns: number of words starting by @letter
+ */
+guint muttum_solver_lexicon_get_first_letter_range (
+    MuttumSolverLexicon *lexicon,
+    gchar letter,
+    guint *first)
+{
+  if (letter < 'a' || letter > 'z') {
+    *first = 0;
+    return 0;
+  }
+
+  *first = lexicon->first_letter_offsets[letter - 'a'];
+  return lexicon->first_letter_offsets[letter - 'a' + 1] - *first;
+}
+
+/*
+ * Returns: number of words of the largest first letter group
+ */
+guint muttum_solver_lexicon_get_first_letter_max (MuttumSolverLexicon *lexicon)
+{
+  guint n_words = 0;
+
+  for (guint i = 0; i < 26; i += 1) {
+    n_words = MAX(n_words, lexicon->first_letter_offsets[i + 1] - lexicon->first_letter_offsets[i]);
+  }
+
+  return n_words;
+}
+
+/*
+ * Returns: (transfer none): SHA-256 digest of the words
+ */
+const guint8 *muttum_solver_lexicon_get_checksum (MuttumSolverLexicon *lexicon)
+{
+  return lexicon->checksum;
+}
+
+/*
+ * muttum_solver_lexicon_set_matrix:
+ * @matrix: (transfer full): patterns precomputed for this lexicon
+ */
+void muttum_solver_lexicon_set_matrix (
+    MuttumSolverLexicon *lexicon,
+    MuttumPatternMatrix *matrix)
+{
+  muttum_pattern_matrix_free(lexicon->matrix);
+  lexicon->matrix = matrix;
+}
+
+/*
+ * Returns: (transfer none): the letters of the word, not NUL terminated
+ */
+const gchar *muttum_solver_lexicon_get_word (
+    MuttumSolverLexicon *lexicon,
+    guint position)
+{
+  g_return_val_if_fail(position < lexicon->n_words, NULL);
+  return lexicon->words + position * lexicon->length;
+}
+
+const guint16 muttum_solver_pattern_weights[256] = {
+  0, 1, 3, 4, 9, 10, 12, 13, 27, 28, 30, 31, 36, 37, 39, 40,
+  81, 82, 84, 85, 90, 91, 93, 94, 108, 109, 111, 112, 117, 118, 120, 121,
+  243, 244, 246, 247, 252, 253, 255, 256, 270, 271, 273, 274, 279, 280, 282, 283,
+  324, 325, 327, 328, 333, 334, 336, 337, 351, 352, 354, 355, 360, 361, 363, 364,
+  729, 730, 732, 733, 738, 739, 741, 742, 756, 757, 759, 760, 765, 766, 768, 769,
+  810, 811, 813, 814, 819, 820, 822, 823, 837, 838, 840, 841, 846, 847, 849, 850,
+  972, 973, 975, 976, 981, 982, 984, 985, 999, 1000, 1002, 1003, 1008, 1009, 1011, 1012,
+  1053, 1054, 1056, 1057, 1062, 1063, 1065, 1066, 1080, 1081, 1083, 1084, 1089, 1090, 1092, 1093,
+  2187, 2188, 2190, 2191, 2196, 2197, 2199, 2200, 2214, 2215, 2217, 2218, 2223, 2224, 2226, 2227,
+  2268, 2269, 2271, 2272, 2277, 2278, 2280, 2281, 2295, 2296, 2298, 2299, 2304, 2305, 2307, 2308,
+  2430, 2431, 2433, 2434, 2439, 2440, 2442, 2443, 2457, 2458, 2460, 2461, 2466, 2467, 2469, 2470,
+  2511, 2512, 2514, 2515, 2520, 2521, 2523, 2524, 2538, 2539, 2541, 2542, 2547, 2548, 2550, 2551,
+  2916, 2917, 2919, 2920, 2925, 2926, 2928, 2929, 2943, 2944, 2946, 2947, 2952, 2953, 2955, 2956,
+  2997, 2998, 3000, 3001, 3006, 3007, 3009, 3010, 3024, 3025, 3027, 3028, 3033, 3034, 3036, 3037,
+  3159, 3160, 3162, 3163, 3168, 3169, 3171, 3172, 3186, 3187, 3189, 3190, 3195, 3196, 3198, 3199,
+  3240, 3241, 3243, 3244, 3249, 3250, 3252, 3253, 3267, 3268, 3270, 3271, 3276, 3277, 3279, 3280,
+};
+
+/*
+ * Expected information given by each guess of the chunk, in bits.
+ */
+static void muttum_solver_chunk_run (gpointer data, G_GNUC_UNUSED gpointer user_data)
+{
+  MuttumSolverChunk *chunk = data;
+  MuttumSolverJob *job = chunk->job;
+  guint32 *histogram = g_new0(guint32, job->n_patterns);
+  guint16 *patterns = g_new(guint16, job->n_candidates);
+  gdouble log_candidates = log2(job->n_candidates);
+
+  chunk->best = -1;
+  chunk->best_entropy = -1;
+
+  for (guint guess = chunk->start; guess < chunk->end; guess += 1) {
+    // Histogram positions of the guess patterns against each candidate
+    if (job->matrix_block && job->pattern_size == 1) {
+      const guint8 *row = job->matrix_block + (gsize) guess * job->n_guesses;
+      for (guint i = 0; i < job->n_candidates; i += 1) {
+        patterns[i] = row[job->candidate_positions[i]];
+      }
+    } else if (job->matrix_block) {
+      const guint16 *row = (const guint16 *) job->matrix_block + (gsize) guess * job->n_guesses;
+      for (guint i = 0; i < job->n_candidates; i += 1) {
+        patterns[i] = row[job->candidate_positions[i]];
+      }
+    } else {
+      muttum_score_batch(job->guesses[guess], job->candidates, job->n_candidates, job->length, patterns);
+      for (guint i = 0; i < job->n_candidates; i += 1) {
+        patterns[i] = muttum_solver_pattern_index(patterns[i]);
+      }
+    }
+
+    for (guint i = 0; i < job->n_candidates; i += 1) {
+      histogram[patterns[i]] += 1;
+    }
+
+    // Only touched patterns are read and reset
+    gdouble sum = 0;
+    for (guint i = 0; i < job->n_candidates; i += 1) {
+      guint32 count = histogram[patterns[i]];
+      if (count > 0) {
+        sum += count * log2(count);
+        histogram[patterns[i]] = 0;
+      }
+    }
+
+    gdouble entropy = log_candidates - sum / job->n_candidates;
+
+    // A candidate may be the word to find: prefer it on equal information
+    if (entropy > chunk->best_entropy
+        || (entropy == chunk->best_entropy
+          && muttum_solver_bits_test(job->candidate_bits, guess)
+          && !muttum_solver_bits_test(job->candidate_bits, chunk->best))) {
+      chunk->best = guess;
+      chunk->best_entropy = entropy;
+    }
+  }
+
+  g_free(patterns);
+  g_free(histogram);
+
+  g_mutex_lock(&job->mutex);
+  job->pending -= 1;
+  if (job->pending == 0) {
+    g_cond_signal(&job->cond);
+  }
+  g_mutex_unlock(&job->mutex);
+}
+
+static GThreadPool *muttum_solver_get_pool (void)
+{
+  static gsize pool = 0;
+
+  if (g_once_init_enter(&pool)) {
+    g_autoptr(GError) error = NULL;
+    GThreadPool *new_pool = g_thread_pool_new(muttum_solver_chunk_run, NULL,
+        g_get_num_processors(), FALSE, &error);
+    if (!new_pool) {
+      g_error("Unable to create solver threads: %s", error->message);
+    }
+    g_once_init_leave(&pool, (gsize) new_pool);
+  }
+
+  return (GThreadPool *) pool;
+}
+
+/*
+ * muttum_solver_candidates_new:
+ * @first_letter: the first letter, given by the game
+ *
+ * Returns: (transfer full): every word of @lexicon starting by @first_letter
+ */
+MuttumSolverCandidates *muttum_solver_candidates_new (
+    MuttumSolverLexicon *lexicon,
+    gchar first_letter)
+{
+  MuttumSolverCandidates *candidates = g_new0(MuttumSolverCandidates, 1);
+  muttum_solver_candidates_reset(candidates, lexicon, first_letter);
+
+  return candidates;
+}
+
+/*
+ * muttum_solver_candidates_reset:
+ * @first_letter: the first letter, given by the game
+ *
+ * Makes every word of @lexicon starting by @first_letter a candidate again.
+ * The bitset is only reallocated when the group is larger than every
+ * previous one.
+ */
+void muttum_solver_candidates_reset (
+    MuttumSolverCandidates *candidates,
+    MuttumSolverLexicon *lexicon,
+    gchar first_letter)
+{
+  guint n_words = muttum_solver_lexicon_get_first_letter_range(lexicon, first_letter, &candidates->first);
+  guint n_blocks = (n_words + 63) / 64;
+
+  muttum_solver_candidates_reserve(candidates, n_words);
+
+  candidates->lexicon = lexicon;
+  candidates->first_letter = first_letter;
+  candidates->n_words = n_words;
+  candidates->count = n_words;
+  memset(candidates->bits, 0xff, n_blocks * sizeof(guint64));
+
+  // Bits past the last word stay cleared, so iteration doesn't see them
+  if (n_words % 64 != 0) {
+    candidates->bits[n_blocks - 1] = (G_GUINT64_CONSTANT(1) << (n_words % 64)) - 1;
+  }
+}
+
+/*
+ * muttum_solver_candidates_reserve:
+ * @n_words: size of the largest group to come
+ *
+ * Grows the bitset so resets to groups of up to @n_words words don't
+ * allocate.
+ */
+void muttum_solver_candidates_reserve (
+    MuttumSolverCandidates *candidates,
+    guint n_words)
+{
+  guint n_blocks = (n_words + 63) / 64;
+
+  if (n_blocks > candidates->n_blocks_allocated || !candidates->bits) {
+    g_free(candidates->bits);
+    candidates->n_blocks_allocated = MAX(n_blocks, 1);
+    candidates->bits = g_new(guint64, candidates->n_blocks_allocated);
+  }
+}
+
+void muttum_solver_candidates_free (MuttumSolverCandidates *candidates)
+{
+  if (!candidates) {
+    return;
+  }
+
+  g_free(candidates->bits);
+  g_free(candidates);
+}
+
+/*
+ * muttum_solver_candidates_filter:
+ * @word: the packed word of a validated row
+ * @pattern: the feedback pattern of the row
+ *
+ * Drops the candidates which wouldn't give @pattern to @word. Only the
+ * remaining candidates are scored, so each row costs less than the one
+ * before.
+ *
+ * Returns: the number of remaining candidates
+ */
+guint muttum_solver_candidates_filter (
+    MuttumSolverCandidates *candidates,
+    guint64 word,
+    guint16 pattern)
+{
+  const guint64 *words = candidates->lexicon->packed_words + candidates->first;
+  guint n_blocks = (candidates->n_words + 63) / 64;
+  guint64 targets[64];
+  guint16 patterns[64];
+  guint positions[64];
+
+  for (guint block = 0; block < n_blocks; block += 1) {
+    guint64 bits = candidates->bits[block];
+    guint n_targets = 0;
+
+    // Gathers the block candidates to score them in one batch
+    while (bits) {
+      guint bit = muttum_solver_bits_first(bits);
+      positions[n_targets] = bit;
+      targets[n_targets] = words[block * 64 + bit];
+      n_targets += 1;
+      bits &= bits - 1;
+    }
+
+    if (n_targets == 0) {
+      continue;
+    }
+
+    muttum_score_batch(word, targets, n_targets, candidates->lexicon->length, patterns);
+    for (guint i = 0; i < n_targets; i += 1) {
+      if (patterns[i] != pattern) {
+        candidates->bits[block] &= ~(G_GUINT64_CONSTANT(1) << positions[i]);
+        candidates->count -= 1;
+      }
+    }
+  }
+
+  return candidates->count;
+}
+
+guint muttum_solver_candidates_get_count (MuttumSolverCandidates *candidates)
+{
+  return candidates->count;
+}
+
+/*
+ * Returns: (transfer none): the lexicon the candidates are taken from
+ */
+MuttumSolverLexicon *muttum_solver_candidates_get_lexicon (MuttumSolverCandidates *candidates)
+{
+  return candidates->lexicon;
+}
+
+/*
+ * muttum_solver_candidates_next:
+ * @position: position in the lexicon of the previous candidate, or -1 to
+ *   get the first one
+ *
+ * Returns: position in the lexicon of the next candidate, or -1 after the
+ * last one
+ */
+gint64 muttum_solver_candidates_next (
+    MuttumSolverCandidates *candidates,
+    gint64 position)
+{
+  guint64 i = position < candidates->first ? 0 : position - candidates->first + 1;
+
+  while (i < candidates->n_words) {
+    guint64 bits = candidates->bits[i / 64] >> (i % 64);
+    if (bits) {
+      return candidates->first + i + muttum_solver_bits_first(bits);
+    }
+    i = (i / 64 + 1) * 64;
+  }
+
+  return -1;
+}
+
+/*
+ * muttum_solver_suggest:
+ * @candidates: words still consistent with the validated rows
+ *
+ * Computes, for each word of the lexicon with the same first letter as
+ * @candidates, the expected information given by its feedback over
+ * @candidates. Guesses are split in chunks scored by a thread pool, patterns
+ * are read from the pattern matrix when the lexicon has one.
+ *
+ * Returns: the position in the lexicon of the best guess, or -1 if there is
+ * no candidate left
+ */
+gint64 muttum_solver_suggest (MuttumSolverCandidates *candidates)
+{
+  MuttumSolverLexicon *lexicon = candidates->lexicon;
+  guint first = candidates->first;
+  guint n_guesses = candidates->n_words;
+  const guint64 *guesses = lexicon->packed_words + first;
+
+  // With two candidates or less, no guess does better than a candidate
+  if (candidates->count == 0) {
+    return -1;
+  } else if (candidates->count <= 2) {
+    return muttum_solver_candidates_next(candidates, -1);
+  }
+
+  g_autofree guint64 *candidate_words = g_new(guint64, candidates->count);
+  g_autofree guint *candidate_positions = g_new(guint, candidates->count);
+  guint n_candidates = 0;
+  for (gint64 position = muttum_solver_candidates_next(candidates, -1);
+       position >= 0;
+       position = muttum_solver_candidates_next(candidates, position)) {
+    candidate_words[n_candidates] = lexicon->packed_words[position];
+    candidate_positions[n_candidates] = position - first;
+    n_candidates += 1;
+  }
+
+  MuttumSolverJob job = {
+    .guesses = guesses,
+    .n_guesses = n_guesses,
+    .length = lexicon->length,
+    .n_patterns = 1,
+    .candidates = candidate_words,
+    .candidate_positions = candidate_positions,
+    .n_candidates = n_candidates,
+    .candidate_bits = candidates->bits,
+    .matrix_block = NULL,
+    .pattern_size = 0,
+  };
+  for (guint i = 1; i < lexicon->length; i += 1) {
+    job.n_patterns *= 3;
+  }
+  if (lexicon->matrix) {
+    job.matrix_block = muttum_pattern_matrix_get_block(lexicon->matrix, candidates->first_letter);
+    job.pattern_size = muttum_pattern_matrix_get_pattern_size(lexicon->matrix);
+  }
+  g_mutex_init(&job.mutex);
+  g_cond_init(&job.cond);
+
+  GThreadPool *pool = muttum_solver_get_pool();
+  guint n_chunks = MIN(n_guesses, g_get_num_processors() * MUTTUM_SOLVER_CHUNKS_BY_THREAD);
+  g_autofree MuttumSolverChunk *chunks = g_new0(MuttumSolverChunk, n_chunks);
+
+  job.pending = n_chunks;
+  for (guint i = 0; i < n_chunks; i += 1) {
+    chunks[i].job = &job;
+    chunks[i].start = (guint64) n_guesses * i / n_chunks;
+    chunks[i].end = (guint64) n_guesses * (i + 1) / n_chunks;
+    g_thread_pool_push(pool, &chunks[i], NULL);
+  }
+
+  g_mutex_lock(&job.mutex);
+  while (job.pending > 0) {
+    g_cond_wait(&job.cond, &job.mutex);
+  }
+  g_mutex_unlock(&job.mutex);
+
+  g_mutex_clear(&job.mutex);
+  g_cond_clear(&job.cond);
+
+  // Chunks are merged in order so the result doesn't depend on scheduling
+  gint64 best = -1;
+  gdouble best_entropy = -1;
+  for (guint i = 0; i < n_chunks; i += 1) {
+    if (chunks[i].best < 0) {
+      continue;
+    }
+    if (chunks[i].best_entropy > best_entropy
+        || (chunks[i].best_entropy == best_entropy
+          && muttum_solver_bits_test(candidates->bits, chunks[i].best)
+          && !muttum_solver_bits_test(candidates->bits, best))) {
+      best = chunks[i].best;
+      best_entropy = chunks[i].best_entropy;
+    }
+  }
+
+  return first + best;
+}
@@ -0,0 +1,109 @@
+/* muttum-solver.h
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+#include "muttum-score.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Entropy based solver over the folded (a-z only) playable words of one
+ * length. Feedback patterns are computed by muttum_score_batch().
+ * */
+
+#define MUTTUM_SOLVER_LENGTH_MAX MUTTUM_SCORE_WORD_LENGTH_MAX
+#define MUTTUM_SOLVER_CHECKSUM_SIZE 32
+
+typedef struct _MuttumSolverLexicon MuttumSolverLexicon;
+typedef struct _MuttumSolverCandidates MuttumSolverCandidates;
+typedef struct _MuttumPatternMatrix MuttumPatternMatrix;
+
+MuttumSolverLexicon *muttum_solver_lexicon_new (guint length,
+                                                GByteArray *words);
+
+void muttum_solver_lexicon_free (MuttumSolverLexicon *lexicon);
+
+guint muttum_solver_lexicon_get_n_words (MuttumSolverLexicon *lexicon);
+
+const gchar *muttum_solver_lexicon_get_word (MuttumSolverLexicon *lexicon,
+                                             guint position);
+
+guint muttum_solver_lexicon_get_length (MuttumSolverLexicon *lexicon);
+
+const guint64 *muttum_solver_lexicon_get_packed_words (MuttumSolverLexicon *lexicon);
+
+guint muttum_solver_lexicon_get_first_letter_range (MuttumSolverLexicon *lexicon,
+                                                    gchar letter,
+                                                    guint *first);
+
+guint muttum_solver_lexicon_get_first_letter_max (MuttumSolverLexicon *lexicon);
+
+const guint8 *muttum_solver_lexicon_get_checksum (MuttumSolverLexicon *lexicon);
+
+void muttum_solver_lexicon_set_matrix (MuttumSolverLexicon *lexicon,
+                                       MuttumPatternMatrix *matrix);
+
+MuttumSolverCandidates *muttum_solver_candidates_new (MuttumSolverLexicon *lexicon,
+                                                      gchar first_letter);
+
+void muttum_solver_candidates_reset (MuttumSolverCandidates *candidates,
+                                     MuttumSolverLexicon *lexicon,
+                                     gchar first_letter);
+
+void muttum_solver_candidates_reserve (MuttumSolverCandidates *candidates,
+                                       guint n_words);
+
+void muttum_solver_candidates_free (MuttumSolverCandidates *candidates);
+
+guint muttum_solver_candidates_filter (MuttumSolverCandidates *candidates,
+                                       guint64 word,
+                                       guint16 pattern);
+
+guint muttum_solver_candidates_get_count (MuttumSolverCandidates *candidates);
+
+gint64 muttum_solver_candidates_next (MuttumSolverCandidates *candidates,
+                                      gint64 position);
+
+MuttumSolverLexicon *muttum_solver_candidates_get_lexicon (MuttumSolverCandidates *candidates);
+
+gint64 muttum_solver_suggest (MuttumSolverCandidates *candidates);
+
+/*
+ * Weight of each well placed or present letters mask, when the pattern is
+ * read as a base 3 number.
+ */
+extern const guint16 muttum_solver_pattern_weights[256];
+
+/*
+ * Histogram position of a pattern between words of the same first letter:
+ * the first letter is always well placed and left out, so there are
+ * 3^(length - 1) positions.
+ */
+static inline guint muttum_solver_pattern_index (guint16 pattern)
+{
+  return 2 * muttum_solver_pattern_weights[MUTTUM_SCORE_PATTERN_WELL_PLACED(pattern) >> 1]
+    + muttum_solver_pattern_weights[MUTTUM_SCORE_PATTERN_PRESENT(pattern) >> 1];
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MuttumSolverLexicon, muttum_solver_lexicon_free)
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MuttumSolverCandidates, muttum_solver_candidates_free)
+
+G_END_DECLS
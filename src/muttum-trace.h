@@ -0,0 +1,66 @@
+/* muttum-trace.h
+ *
+ * Copyright 2022 Adrien Dorsaz
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+#ifdef MUTTUM_HAVE_SYSPROF
+  #include <sysprof-capture.h>
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * Spans of the engine phases, shown as marks of the "Muttum" group by
+ * sysprof when it records the process. Without sysprof-capture at build
+ * time, spans compile to nothing.
+ *
+ *   gint64 begin_time = MUTTUM_TRACE_BEGIN();
+ *   ...
+ *   MUTTUM_TRACE_END(begin_time, "validate", "row %u", row);
+ * */
+
+#ifdef MUTTUM_HAVE_SYSPROF
+  #define MUTTUM_TRACE_BEGIN() SYSPROF_CAPTURE_CURRENT_TIME
+  #define MUTTUM_TRACE_END(begin_time, name, ...) \
+    sysprof_collector_mark_printf((begin_time), SYSPROF_CAPTURE_CURRENT_TIME - (begin_time), \
+        "Muttum", (name), __VA_ARGS__)
+#else
+  #define MUTTUM_TRACE_BEGIN() G_GINT64_CONSTANT(0)
+  #define MUTTUM_TRACE_END(begin_time, name, ...) muttum_trace_end((begin_time), (name), __VA_ARGS__)
+
+/*
+ * Does nothing, but the arguments stay used and the format checked as with
+ * sysprof.
+ */
+static inline void muttum_trace_end (gint64 begin_time,
+                                     const gchar *name,
+                                     const gchar *format,
+                                     ...) G_GNUC_PRINTF (3, 4);
+
+static inline void
+muttum_trace_end (G_GNUC_UNUSED gint64 begin_time,
+                  G_GNUC_UNUSED const gchar *name,
+                  G_GNUC_UNUSED const gchar *format,
+                  ...)
+{
+}
+#endif
+
+G_END_DECLS
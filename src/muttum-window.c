@@ -22,24 +22,41 @@
 #include "muttum-window.h"
 #include "muttum-engine.h"
 
-typedef struct {
-  GtkLabel *label;
-  MuttumLetter *letter;
-} labelData;
+// Keys kept while a row is revealed, replayed at the end of the reveal
+#define MUTTUM_WINDOW_TYPE_AHEAD_SIZE 32
+
+// Type-ahead keys which aren't letters
+#define MUTTUM_WINDOW_KEY_BACKSPACE '\b'
+#define MUTTUM_WINDOW_KEY_RETURN '\n'
+
+// Letter typed by each Latin-1 keyval, accents are dropped, see
+// muttum_window_class_init()
+static gchar muttum_window_key_letters[256];
+
+// Time between two letters of the reveal, in microseconds
+#define MUTTUM_WINDOW_REVEAL_STEP 200000
 
 static void muttum_window_display_board (
-    MuttumWindow* self,
-    gboolean apply_delay,
-    guint delay_on_row
-    );
+    MuttumWindow* self);
 static void
-muttum_window_on_key_released (
+muttum_window_constructed (
+    GObject *gobject);
+static void
+muttum_window_set_engine (
+    MuttumWindow *self,
+    MuttumEngine *engine);
+static gboolean
+muttum_window_on_key_pressed (
     GtkEventControllerKey *self,
     guint keyval,
     guint keycode,
     GdkModifierType state,
     gpointer user_data);
 static void
+muttum_window_handle_key (
+    MuttumWindow *self,
+    gchar key);
+static void
 muttum_window_action_new_game (
     GtkWidget *sender,
     G_GNUC_UNUSED const char *action,
@@ -47,6 +64,9 @@ muttum_window_action_new_game (
 static void
 muttum_window_display_alphabet (
     MuttumWindow *self);
+static void
+muttum_window_display_candidates (
+    MuttumWindow *self);
 
 struct _MuttumWindow
 {
@@ -55,21 +75,93 @@ struct _MuttumWindow
   /* Template widgets */
   AdwHeaderBar        *header_bar;
   AdwToastOverlay     *toast_overlay;
+  GtkStack            *game_stack;
+  AdwStatusPage       *error_page;
   GtkGrid             *game_grid;
   GtkGrid             *alphabet_grid;
+  GtkLabel            *candidate_label;
 
   GtkCssProvider      *css_provider;
   MuttumEngine      *engine;
+  GCancellable        *engine_cancellable;
+  // Game resumed by the engine, see muttum_engine_serialize()
+  GBytes              *saved_game;
   gboolean            is_validating;
+
+  // Labels of the board cells row after row, and of the alphabet letters,
+  // owned by their grid
+  GtkLabel            **board_labels;
+  guint               board_length;
+  GtkLabel            *alphabet_labels[26];
+
+  // Bit l is set if the alphabet label of letter 'a' + l is updated at the
+  // end of the reveal
+  guint32             pending_alphabet;
+
+  // Reveal of a validated row, driven by the frame clock: a cell by step,
+  // the first letter of the next row included
+  guint               reveal_tick_id;
+  guint               reveal_row;
+  guint               reveal_step;
+  guint               reveal_n_steps;
+  gint64              reveal_start_time;
+
+  // Ring buffer of the keys typed while validating
+  gchar               type_ahead[MUTTUM_WINDOW_TYPE_AHEAD_SIZE];
+  guint               type_ahead_start;
+  guint               type_ahead_length;
+
+  // Time of the first key not painted yet, with MUTTUM_DEBUG_LATENCY
+  gboolean            debug_latency;
+  gint64              key_time;
+
+  // Startup timings, in microseconds from window creation
+  gint64              init_time;
 };
 
 G_DEFINE_TYPE (MuttumWindow, muttum_window, ADW_TYPE_APPLICATION_WINDOW)
 
+enum {
+  PROP_0,
+  PROP_SAVED_GAME,
+  N_PROPERTIES,
+};
+
+static GParamSpec *properties[N_PROPERTIES] = { NULL, };
+
+static void
+muttum_window_set_property (
+    GObject *gobject,
+    guint property_id,
+    const GValue *value,
+    GParamSpec *pspec)
+{
+  MuttumWindow *self = MUTTUM_WINDOW(gobject);
+
+  switch (property_id) {
+    case PROP_SAVED_GAME:
+      g_clear_pointer(&self->saved_game, g_bytes_unref);
+      self->saved_game = g_value_dup_boxed(value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, property_id, pspec);
+      break;
+  }
+}
+
 static void
 muttum_window_dispose (GObject *gobject)
 {
   MuttumWindow * self = MUTTUM_WINDOW(gobject);
+  g_cancellable_cancel(self->engine_cancellable);
+  g_clear_object(&self->engine_cancellable);
+  if (self->reveal_tick_id) {
+    gtk_widget_remove_tick_callback(GTK_WIDGET (self), self->reveal_tick_id);
+    self->reveal_tick_id = 0;
+  }
   g_clear_object(&self->engine);
+  g_clear_pointer(&self->saved_game, g_bytes_unref);
+  g_clear_pointer(&self->board_labels, g_free);
 
   G_OBJECT_CLASS (muttum_window_parent_class)->dispose (gobject);
 }
@@ -80,20 +172,122 @@ muttum_window_class_init (MuttumWindowClass *klass)
   GObjectClass *g_object_class = G_OBJECT_CLASS(klass);
   GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
+  g_object_class->set_property = muttum_window_set_property;
+  g_object_class->constructed = muttum_window_constructed;
   g_object_class->dispose = muttum_window_dispose;
 
+  /**
+   * MuttumWindow:saved-game:
+   *
+   * Game to resume instead of starting a new one, see
+   * muttum_engine_serialize().
+   */
+  properties[PROP_SAVED_GAME] = g_param_spec_boxed(
+      "saved-game", "Saved game",
+      "Game to resume",
+      G_TYPE_BYTES,
+      G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties(g_object_class, N_PROPERTIES, properties);
+
   gtk_widget_class_set_template_from_resource (widget_class, "/org/muttum/Muttum/muttum-window.ui");
   gtk_widget_class_bind_template_child (widget_class, MuttumWindow, header_bar);
+  gtk_widget_class_bind_template_child (widget_class, MuttumWindow, game_stack);
+  gtk_widget_class_bind_template_child (widget_class, MuttumWindow, error_page);
   gtk_widget_class_bind_template_child (widget_class, MuttumWindow, game_grid);
   gtk_widget_class_bind_template_child (widget_class, MuttumWindow, alphabet_grid);
   gtk_widget_class_bind_template_child (widget_class, MuttumWindow, toast_overlay);
+  gtk_widget_class_bind_template_child (widget_class, MuttumWindow, candidate_label);
 
   gtk_widget_class_install_action(widget_class, "game.new", NULL, muttum_window_action_new_game);
+
+  // Keys are matched once here instead of on each key press
+  g_autoptr(GRegex) letter_regex = g_regex_new(
+      "^[a-z](acute|circumflex|diaeresis|grave|cedilla)?$",
+      G_REGEX_CASELESS, 0, NULL);
+  for (guint keyval = 0; keyval < G_N_ELEMENTS(muttum_window_key_letters); keyval += 1) {
+    const char *keyname = gdk_keyval_name(keyval);
+    if (keyname && g_regex_match(letter_regex, keyname, 0, NULL)) {
+      muttum_window_key_letters[keyval] = g_ascii_tolower(keyname[0]);
+    }
+  }
+}
+
+static gboolean
+muttum_window_on_first_frame (
+    GtkWidget *widget,
+    G_GNUC_UNUSED GdkFrameClock *frame_clock,
+    G_GNUC_UNUSED gpointer user_data)
+{
+  MuttumWindow *self = MUTTUM_WINDOW (widget);
+  g_debug("MuttumWindow: time to first frame: %.1f ms",
+      (g_get_monotonic_time() - self->init_time) / 1000.0);
+  return G_SOURCE_REMOVE;
+}
+
+static void
+muttum_window_on_after_paint (
+    G_GNUC_UNUSED GdkFrameClock *frame_clock,
+    gpointer user_data)
+{
+  MuttumWindow *self = MUTTUM_WINDOW (user_data);
+
+  if (self->key_time == 0) {
+    return;
+  }
+
+  g_debug("MuttumWindow: key to paint latency: %.2f ms",
+      (g_get_monotonic_time() - self->key_time) / 1000.0);
+  self->key_time = 0;
+}
+
+static void
+muttum_window_on_realize (
+    GtkWidget *widget,
+    G_GNUC_UNUSED gpointer user_data)
+{
+  GdkFrameClock *frame_clock = gtk_widget_get_frame_clock(widget);
+  g_signal_connect_object(frame_clock, "after-paint", G_CALLBACK(muttum_window_on_after_paint), widget, 0);
+}
+
+static void
+muttum_window_on_engine_ready (
+    G_GNUC_UNUSED GObject *source_object,
+    GAsyncResult *result,
+    gpointer user_data)
+{
+  g_autoptr(GError) error = NULL;
+  MuttumEngine *engine = muttum_engine_new_finish(result, &error);
+
+  // Window may be already destroyed
+  if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    return;
+  }
+
+  g_return_if_fail(MUTTUM_IS_WINDOW(user_data));
+  MuttumWindow *self = MUTTUM_WINDOW (user_data);
+
+  // Words couldn't be loaded, the game can't start
+  if (!engine) {
+    g_warning("Unable to create game engine: %s", error->message);
+    adw_status_page_set_description(self->error_page, error->message);
+    gtk_stack_set_visible_child_name(self->game_stack, "error");
+    return;
+  }
+
+  muttum_window_set_engine(self, engine);
+  gtk_stack_set_visible_child_name(self->game_stack, "game");
+  gtk_widget_action_set_enabled(GTK_WIDGET (self), "game.new", TRUE);
+
+  g_debug("MuttumWindow: time to playable: %.1f ms",
+      (g_get_monotonic_time() - self->init_time) / 1000.0);
 }
 
 static void
 muttum_window_init (MuttumWindow *self)
 {
+  self->init_time = g_get_monotonic_time();
+
   gtk_widget_init_template (GTK_WIDGET (self));
 
   // CSS style
@@ -102,20 +296,53 @@ muttum_window_init (MuttumWindow *self)
   gtk_css_provider_load_from_resource(self->css_provider, "/org/muttum/Muttum/muttum-window.css");
   gtk_style_context_add_provider_for_display(display, GTK_STYLE_PROVIDER (self->css_provider), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
 
-  // Engine
-  self->engine = g_object_new(MUTTUM_TYPE_ENGINE, NULL);
+  // Engine is created in a worker thread while loading page is displayed
+  self->engine = NULL;
+  self->engine_cancellable = g_cancellable_new();
   self->is_validating = FALSE;
-  muttum_window_display_board(self, FALSE, 0);
+  gtk_stack_set_visible_child_name(self->game_stack, "loading");
+  gtk_widget_action_set_enabled(GTK_WIDGET (self), "game.new", FALSE);
+  gtk_widget_add_tick_callback(GTK_WIDGET (self), muttum_window_on_first_frame, NULL, NULL);
 
   // Event management
   GtkEventController *controller = gtk_event_controller_key_new();
   gtk_widget_add_controller(GTK_WIDGET(self), controller);
   gtk_event_controller_set_propagation_phase(controller, GTK_PHASE_CAPTURE);
-  g_signal_connect(controller, "key-released", G_CALLBACK(muttum_window_on_key_released), NULL);
+  g_signal_connect(controller, "key-pressed", G_CALLBACK(muttum_window_on_key_pressed), NULL);
+
+  self->debug_latency = g_getenv("MUTTUM_DEBUG_LATENCY") != NULL;
+  if (self->debug_latency) {
+    g_signal_connect(self, "realize", G_CALLBACK(muttum_window_on_realize), NULL);
+  }
 
   gtk_widget_grab_focus(GTK_WIDGET (self));
 }
 
+static void
+muttum_window_constructed (GObject *gobject)
+{
+  MuttumWindow *self = MUTTUM_WINDOW(gobject);
+
+  // The saved game, if any, is resumed without picking a new word
+  muttum_engine_resume_async(self->saved_game, self->engine_cancellable, muttum_window_on_engine_ready, self);
+  g_clear_pointer(&self->saved_game, g_bytes_unref);
+
+  G_OBJECT_CLASS (muttum_window_parent_class)->constructed (gobject);
+}
+
+/**
+ * muttum_window_get_engine:
+ *
+ * Returns: (transfer none) (nullable): the engine of the game, %NULL while
+ * it is created
+ */
+MuttumEngine *
+muttum_window_get_engine (MuttumWindow *self)
+{
+  g_return_val_if_fail(MUTTUM_IS_WINDOW(self), NULL);
+  return self->engine;
+}
+
 static void
 muttum_window_action_new_game (
     GtkWidget *sender,
@@ -126,55 +353,70 @@ muttum_window_action_new_game (
   MuttumWindow *self = MUTTUM_WINDOW (sender);
 
   // Reset Game Grid
-  GPtrArray* board = muttum_engine_get_board_state(self->engine);
-  for (guint i = 0; i < board->len; i += 1) {
+  guint n_rows = 0;
+  muttum_engine_peek_board(self->engine, &n_rows, NULL);
+  for (guint i = 0; i < n_rows; i += 1) {
     gtk_grid_remove_row(self->game_grid, 0);
   }
+  g_clear_pointer(&self->board_labels, g_free);
 
-  // Reset Engine
-  g_clear_object(&self->engine);
-  self->engine = g_object_new(MUTTUM_TYPE_ENGINE, NULL);
-  self->is_validating = FALSE;
+  // Stop the reveal of the previous game
+  if (self->reveal_tick_id) {
+    gtk_widget_remove_tick_callback(GTK_WIDGET (self), self->reveal_tick_id);
+    self->reveal_tick_id = 0;
+  }
 
-  // Display board and alphabet
-  muttum_window_display_board(self, FALSE, 0);
+  // Reset Engine, its game state and signal handlers are kept
+  self->is_validating = FALSE;
+  self->pending_alphabet = 0;
+  self->type_ahead_length = 0;
+  muttum_engine_reset(self->engine);
+  muttum_window_display_board(self);
   muttum_window_display_alphabet(self);
+  muttum_window_display_candidates(self);
 }
 
-static gboolean muttum_window_set_label_data (gpointer user_data) {
-  labelData *label_data = user_data;
-
-  GString *labelString = g_string_new(NULL);
-  g_string_append_c(labelString, label_data->letter->letter);
-  gtk_label_set_text(GTK_LABEL (label_data->label), labelString->str);
-  g_string_free(labelString, TRUE);
+static void muttum_window_set_label (GtkLabel *label, const MuttumLetter *letter) {
+  gchar text[2] = { letter->letter, '\0' };
+  gtk_label_set_text(label, text);
 
   // Reset CSS classes
-  gtk_widget_remove_css_class(GTK_WIDGET(label_data->label), "not_present");
-  gtk_widget_remove_css_class(GTK_WIDGET(label_data->label), "well_placed");
-  gtk_widget_remove_css_class(GTK_WIDGET(label_data->label), "present");
+  gtk_widget_remove_css_class(GTK_WIDGET(label), "not_present");
+  gtk_widget_remove_css_class(GTK_WIDGET(label), "well_placed");
+  gtk_widget_remove_css_class(GTK_WIDGET(label), "present");
 
-  switch (label_data->letter->state) {
+  switch (letter->state) {
     case MUTTUM_LETTER_NOT_PRESENT:
-      gtk_widget_add_css_class(GTK_WIDGET(label_data->label), "not_present");
+      gtk_widget_add_css_class(GTK_WIDGET(label), "not_present");
       break;
     case MUTTUM_LETTER_WELL_PLACED:
-      gtk_widget_add_css_class(GTK_WIDGET(label_data->label), "well_placed");
+      gtk_widget_add_css_class(GTK_WIDGET(label), "well_placed");
       break;
     case MUTTUM_LETTER_PRESENT:
-      gtk_widget_add_css_class(GTK_WIDGET(label_data->label), "present");
+      gtk_widget_add_css_class(GTK_WIDGET(label), "present");
       break;
     default:
       break;
   }
-  g_free(user_data);
-  return G_SOURCE_REMOVE;
 }
 
-static gboolean muttum_window_terminate_validation (gpointer user_data) {
-  g_return_val_if_fail(MUTTUM_IS_WINDOW(user_data), G_SOURCE_REMOVE);
-  MuttumWindow *self = user_data;
-  muttum_window_display_alphabet(self);
+static void muttum_window_display_alphabet_letter (MuttumWindow *self, gchar letter) {
+  MuttumLetter alphabet_letter = {
+    .letter = letter,
+    .state = muttum_engine_get_letter_state(self->engine, letter),
+  };
+  muttum_window_set_label(self->alphabet_labels[letter - 'a'], &alphabet_letter);
+}
+
+static void muttum_window_terminate_validation (MuttumWindow *self) {
+  // Alphabet letters are only revealed with the row
+  for (guint letter = 0; letter < 26; letter += 1) {
+    if (self->pending_alphabet & (1 << letter)) {
+      muttum_window_display_alphabet_letter(self, 'a' + letter);
+    }
+  }
+  self->pending_alphabet = 0;
+  muttum_window_display_candidates(self);
   MuttumEngineState state = muttum_engine_get_game_state(self->engine);
   if (state != MUTTUM_ENGINE_STATE_CONTINUE) {
       AdwToast *toast = adw_toast_new(_("Congratulation you won!"));
@@ -195,25 +437,33 @@ static gboolean muttum_window_terminate_validation (gpointer user_data) {
       adw_toast_overlay_add_toast(self->toast_overlay, toast);
   }
   self->is_validating = FALSE;
-  return G_SOURCE_REMOVE;
+
+  // Keys typed during the reveal, until one starts a new validation
+  while (self->type_ahead_length > 0 && !self->is_validating) {
+    gchar key = self->type_ahead[self->type_ahead_start];
+    self->type_ahead_start = (self->type_ahead_start + 1) % MUTTUM_WINDOW_TYPE_AHEAD_SIZE;
+    self->type_ahead_length -= 1;
+    muttum_window_handle_key(self, key);
+  }
 }
 
 static void
 muttum_window_display_board (
-    MuttumWindow *self,
-    gboolean apply_delay,
-    guint delay_on_row)
+    MuttumWindow *self)
 {
   g_return_if_fail(MUTTUM_IS_WINDOW(self));
 
-  GPtrArray* board = muttum_engine_get_board_state(self->engine);
+  // Board is read in place, without copy
+  guint n_rows = 0;
+  guint length = 0;
+  const MuttumLetter *board = muttum_engine_peek_board(self->engine, &n_rows, &length);
 
-  guint longest_delay = 0;
-  for (guint rowIndex = 0; rowIndex < board->len; rowIndex +=1 ) {
-    GPtrArray *row = g_ptr_array_index(board, rowIndex);
-    for (guint columnIndex = 0; columnIndex < row->len; columnIndex += 1) {
-      MuttumLetter *letter = g_ptr_array_index(row, columnIndex);
+  g_free(self->board_labels);
+  self->board_labels = g_new(GtkLabel *, n_rows * length);
+  self->board_length = length;
 
+  for (guint rowIndex = 0; rowIndex < n_rows; rowIndex +=1 ) {
+    for (guint columnIndex = 0; columnIndex < length; columnIndex += 1) {
       GtkWidget* child = gtk_grid_get_child_at(self->game_grid, columnIndex, rowIndex);
       if (!child) {
         child = gtk_label_new(NULL);
@@ -221,34 +471,87 @@ muttum_window_display_board (
         gtk_grid_attach(self->game_grid, child, columnIndex, rowIndex, 1, 1);
       }
 
-      labelData *label_data = g_new(labelData, 1);
-      label_data->label = GTK_LABEL(child);
-      label_data->letter = letter;
-
-      if (self->is_validating && apply_delay
-          && (rowIndex == delay_on_row || rowIndex == delay_on_row + 1)) {
-        guint delay = 200 * columnIndex + 200 * row->len * (rowIndex - delay_on_row);
-        // Delay display of all letters on delay row
-        if (rowIndex == delay_on_row) {
-          g_timeout_add(delay, muttum_window_set_label_data, label_data);
-        } else {
-          // On row just after, only the first letter need to be delayed
-          if (columnIndex == 0) {
-            g_timeout_add(delay, muttum_window_set_label_data, label_data);
-            longest_delay = delay + 200;
-          } else {
-            muttum_window_set_label_data(label_data);
-          }
-        }
-      } else {
-        muttum_window_set_label_data(label_data);
-      }
+      self->board_labels[rowIndex * length + columnIndex] = GTK_LABEL(child);
+      muttum_window_set_label(GTK_LABEL(child), &board[rowIndex * length + columnIndex]);
+    }
+  }
+}
+
+/*
+ * Updates the label of one cell, from its engine letter.
+ */
+static void
+muttum_window_display_cell (
+    MuttumWindow *self,
+    guint row,
+    guint col)
+{
+  const MuttumLetter *board = muttum_engine_peek_board(self->engine, NULL, NULL);
+  guint cell = row * self->board_length + col;
+  muttum_window_set_label(self->board_labels[cell], &board[cell]);
+}
 
+/*
+ * Displays the cells of the reveal whose time has come on this frame, and
+ * terminates the validation one step after the last one.
+ */
+static gboolean
+muttum_window_on_reveal_tick (
+    GtkWidget *widget,
+    GdkFrameClock *frame_clock,
+    G_GNUC_UNUSED gpointer user_data)
+{
+  MuttumWindow *self = MUTTUM_WINDOW (widget);
+  gint64 frame_time = gdk_frame_clock_get_frame_time(frame_clock);
+
+  if (self->reveal_start_time == 0) {
+    self->reveal_start_time = frame_time;
+  }
+
+  gint64 elapsed = frame_time - self->reveal_start_time;
+  while (self->reveal_step < self->reveal_n_steps
+      && elapsed >= (gint64) self->reveal_step * MUTTUM_WINDOW_REVEAL_STEP) {
+    if (self->reveal_step < self->board_length) {
+      muttum_window_display_cell(self, self->reveal_row, self->reveal_step);
+    } else {
+      muttum_window_display_cell(self, self->reveal_row + 1, 0);
     }
+    self->reveal_step += 1;
+  }
+
+  if (elapsed < (gint64) self->reveal_n_steps * MUTTUM_WINDOW_REVEAL_STEP) {
+    return G_SOURCE_CONTINUE;
+  }
+
+  self->reveal_tick_id = 0;
+  muttum_window_terminate_validation(self);
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Reveals the validated row letter after letter, then the first letter of
+ * the next row.
+ */
+static void
+muttum_window_reveal_row (
+    MuttumWindow *self,
+    guint row)
+{
+  guint n_rows = 0;
+  muttum_engine_peek_board(self->engine, &n_rows, NULL);
+
+  self->reveal_row = row;
+  self->reveal_step = 0;
+  self->reveal_n_steps = self->board_length;
+  if (muttum_engine_get_current_row(self->engine) == row + 1 && row + 1 < n_rows) {
+    self->reveal_n_steps += 1;
   }
 
-  // Terminate validation with the current longest delay
-  g_timeout_add(longest_delay, muttum_window_terminate_validation, self);
+  // Starts on the next frame
+  self->reveal_start_time = 0;
+  if (!self->reveal_tick_id) {
+    self->reveal_tick_id = gtk_widget_add_tick_callback(GTK_WIDGET (self), muttum_window_on_reveal_tick, NULL, NULL);
+  }
 }
 
 static void
@@ -257,10 +560,8 @@ muttum_window_display_alphabet (
 {
   g_return_if_fail(MUTTUM_IS_WINDOW(self));
 
-  GPtrArray* alphabet = muttum_engine_get_alphabet_state(self->engine);
-
-  for (guint alphaIndex = 0; alphaIndex < alphabet->len; alphaIndex +=1 ) {
-    MuttumLetter *letter = g_ptr_array_index(alphabet, alphaIndex);
+  for (gchar letter = 'a'; letter <= 'z'; letter += 1) {
+    guint alphaIndex = letter - 'a';
     guint rowIndex = alphaIndex / 13;
     guint columnIndex = alphaIndex % 13;
     GtkWidget* child = gtk_grid_get_child_at(self->alphabet_grid, columnIndex, rowIndex);
@@ -270,16 +571,112 @@ muttum_window_display_alphabet (
       gtk_grid_attach(self->alphabet_grid, child, columnIndex, rowIndex, 1, 1);
     }
 
-    labelData *label_data = g_new(labelData, 1);
-    label_data->label = GTK_LABEL(child);
-    label_data->letter = letter;
+    self->alphabet_labels[alphaIndex] = GTK_LABEL(child);
+    muttum_window_display_alphabet_letter(self, letter);
+  }
+}
+
+static void
+muttum_window_on_cell_changed (
+    G_GNUC_UNUSED MuttumEngine *engine,
+    guint row,
+    guint col,
+    gpointer user_data)
+{
+  MuttumWindow *self = MUTTUM_WINDOW (user_data);
 
-    muttum_window_set_label_data(label_data);
+  // Cells changed by the validation are displayed by the reveal
+  if (self->is_validating) {
+    return;
   }
+
+  muttum_window_display_cell(self, row, col);
+}
+
+static void
+muttum_window_on_row_validated (
+    G_GNUC_UNUSED MuttumEngine *engine,
+    guint row,
+    gpointer user_data)
+{
+  muttum_window_reveal_row(MUTTUM_WINDOW (user_data), row);
 }
 
 static void
-muttum_window_on_key_released (
+muttum_window_on_alphabet_changed (
+    G_GNUC_UNUSED MuttumEngine *engine,
+    gchar letter,
+    gpointer user_data)
+{
+  MuttumWindow *self = MUTTUM_WINDOW (user_data);
+  self->pending_alphabet |= 1 << (letter - 'a');
+}
+
+/*
+ * Displays the whole game of @engine, then only the widgets of its changes.
+ */
+static void
+muttum_window_set_engine (
+    MuttumWindow *self,
+    MuttumEngine *engine)
+{
+  self->engine = engine;
+
+  g_signal_connect_object(engine, "cell-changed", G_CALLBACK(muttum_window_on_cell_changed), self, 0);
+  g_signal_connect_object(engine, "row-validated", G_CALLBACK(muttum_window_on_row_validated), self, 0);
+  g_signal_connect_object(engine, "alphabet-changed", G_CALLBACK(muttum_window_on_alphabet_changed), self, 0);
+
+  muttum_window_display_board(self);
+  muttum_window_display_alphabet(self);
+  muttum_window_display_candidates(self);
+}
+
+static void
+muttum_window_display_candidates (
+    MuttumWindow *self)
+{
+  g_return_if_fail(MUTTUM_IS_WINDOW(self));
+
+  guint count = muttum_engine_get_candidate_count(self->engine);
+  g_autofree gchar *text = g_strdup_printf(ngettext("%u possible word", "%u possible words", count), count);
+  gtk_label_set_text(self->candidate_label, text);
+}
+
+/*
+ * Plays a letter, MUTTUM_WINDOW_KEY_BACKSPACE or MUTTUM_WINDOW_KEY_RETURN.
+ */
+static void
+muttum_window_handle_key (
+    MuttumWindow *self,
+    gchar key)
+{
+  if (key == MUTTUM_WINDOW_KEY_BACKSPACE) {
+    muttum_engine_remove_letter(self->engine);
+  } else if (key == MUTTUM_WINDOW_KEY_RETURN) {
+    // Finished games don't validate rows: no reveal would end the validation
+    if (muttum_engine_get_game_state(self->engine) != MUTTUM_ENGINE_STATE_CONTINUE) {
+      return;
+    }
+
+    // The reveal is started by the row-validated signal
+    self->is_validating = TRUE;
+    GError *error = NULL;
+    muttum_engine_validate(self->engine, &error);
+    if (error) {
+      AdwToast *toast = adw_toast_new(error->message);
+      adw_toast_set_timeout(toast, 2);
+      adw_toast_set_priority(toast, ADW_TOAST_PRIORITY_NORMAL);
+      adw_toast_overlay_add_toast(self->toast_overlay, toast);
+      g_error_free(error);
+      self->is_validating = FALSE;
+    }
+  } else {
+    muttum_engine_add_letter(self->engine, key);
+  }
+}
+
+static gboolean
+muttum_window_on_key_pressed (
     GtkEventControllerKey *self,
     guint keyval,
     guint keycode,
@@ -287,54 +684,48 @@ muttum_window_on_key_released (
     G_GNUC_UNUSED gpointer user_data)
 {
   GtkWidget* widget = gtk_event_controller_get_widget(GTK_EVENT_CONTROLLER(self));
-  g_return_if_fail(MUTTUM_IS_WINDOW(widget));
+  g_return_val_if_fail(MUTTUM_IS_WINDOW(widget), FALSE);
 
   MuttumWindow* window = MUTTUM_WINDOW(widget);
 
-  g_debug("MuttumWindow: key released: val: %d, code: %d, name: %s\n", keyval, keycode, gdk_keyval_name(keyval));
-  fflush(NULL);
+  g_debug("MuttumWindow: key pressed: val: %d, code: %d", keyval, keycode);
 
   // Ignore all key sequence with Control key
   if (state & GDK_CONTROL_MASK)
   {
-    return;
+    return FALSE;
+  }
+
+  gchar key = 0;
+  if (keyval < G_N_ELEMENTS(muttum_window_key_letters)) {
+    key = muttum_window_key_letters[keyval];
+  } else if (keyval == GDK_KEY_BackSpace) {
+    key = MUTTUM_WINDOW_KEY_BACKSPACE;
+  } else if (keyval == GDK_KEY_Return || keyval == GDK_KEY_KP_Enter) {
+    key = MUTTUM_WINDOW_KEY_RETURN;
   }
 
-  // Ignore all keys while validating
-  if (window->is_validating)
+  // Ignore all keys while loading
+  if (!key || !window->engine)
   {
-    return;
+    return FALSE;
   }
 
-  const char *keyname = gdk_keyval_name(keyval);
-  // Window grabs focus on any recognized input to avoid propagate keyboard
-  // event to other widgets (like the main menu button)
-  if (g_regex_match_simple(
-        "^[a-z](acute|diaeresis|grave)?$",
-        keyname,
-        G_REGEX_CASELESS,
-        0)) {
-    muttum_engine_add_letter(window->engine, keyname[0]);
-    muttum_window_display_board(window, FALSE, 0);
-    gtk_widget_grab_focus(widget);
-  } else if (strcmp(keyname, "BackSpace") == 0) {
-    muttum_engine_remove_letter(window->engine);
-    muttum_window_display_board(window, FALSE, 0);
-    gtk_widget_grab_focus(widget);
-  } else if (strcmp(keyname, "Return") == 0) {
-    guint delay_on_row = muttum_engine_get_current_row(window->engine);
-    window->is_validating = TRUE;
-    GError *error = NULL;
-    muttum_engine_validate(window->engine, &error);
-    if (error) {
-      AdwToast *toast = adw_toast_new(error->message);
-      adw_toast_set_timeout(toast, 2);
-      adw_toast_set_priority(toast, ADW_TOAST_PRIORITY_NORMAL);
-      adw_toast_overlay_add_toast(window->toast_overlay, toast);
-      window->is_validating = FALSE;
-    } else {
-      muttum_window_display_board(window, TRUE, delay_on_row);
+  if (window->is_validating) {
+    if (window->type_ahead_length < MUTTUM_WINDOW_TYPE_AHEAD_SIZE) {
+      guint end = (window->type_ahead_start + window->type_ahead_length) % MUTTUM_WINDOW_TYPE_AHEAD_SIZE;
+      window->type_ahead[end] = key;
+      window->type_ahead_length += 1;
+    }
+  } else {
+    if (window->debug_latency && window->key_time == 0) {
+      window->key_time = g_get_monotonic_time();
     }
-    gtk_widget_grab_focus(widget);
+    muttum_window_handle_key(window, key);
   }
+
+  // Window grabs focus on any recognized input to avoid propagate keyboard
+  // event to other widgets (like the main menu button)
+  gtk_widget_grab_focus(widget);
+  return TRUE;
 }
@@ -21,10 +21,14 @@
 #include <gtk/gtk.h>
 #include <adwaita.h>
 
+#include "muttum-engine.h"
+
 G_BEGIN_DECLS
 
 #define MUTTUM_TYPE_WINDOW (muttum_window_get_type())
 
 G_DECLARE_FINAL_TYPE (MuttumWindow, muttum_window, MUTTUM, WINDOW, AdwApplicationWindow)
 
+MuttumEngine *muttum_window_get_engine (MuttumWindow *self);
+
 G_END_DECLS
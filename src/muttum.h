@@ -19,3 +19,4 @@
 #pragma once
 
 #include <muttum-engine.h>
+#include <muttum-score.h>